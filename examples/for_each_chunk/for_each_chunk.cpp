@@ -0,0 +1,43 @@
+/*
+ * Copyright: See LICENSE file that comes with this distribution
+ *
+ */
+
+#include <cstdlib>
+#include <iostream>
+
+#include "cupp/device.h"
+#include "cupp/vector.h"
+#include "cupp/kernel.h"
+#include "cupp/for_each_chunk.h"
+
+#include "kernel_t.h"
+
+using namespace std;
+using namespace cupp;
+
+
+int main() {
+	// lets get a simple CUDA device up and running
+	device d;
+
+	// pretend our data does not fit into the memory of the device
+	const cupp::vector<float>::size_type size       = 10 * 1000 * 1000;
+	const cupp::vector<float>::size_type chunk_size = 1000 * 1000;
+
+	cupp::vector<float> data (size, 1.0f);
+
+	dim3 block_dim (256);
+	dim3 grid_dim  (128);
+
+	// generate the kernel
+	kernel k (get_kernel(), grid_dim, block_dim );
+
+	// the kernel is called for ten chunks, while one chunk is processed the next one is transfered
+	for_each_chunk (d, k, data, chunk_size);
+
+	cout << "first element: " << data[0] << ", last element: " << data[size-1] << endl;
+
+	// NDT
+	return EXIT_SUCCESS;
+}
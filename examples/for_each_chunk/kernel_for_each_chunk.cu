@@ -0,0 +1,20 @@
+/*
+ * Copyright: See LICENSE file that comes with this distribution
+ *
+ */
+
+#include "cupp/deviceT/vector.h"
+#include "kernel_t.h"
+
+// every element of the chunk is doubled, the grid may be smaller than the chunk
+__global__ void global_function (cupp::deviceT::vector<float> *chunk) {
+	const int stride = gridDim.x * blockDim.x;
+
+	for (int i = blockIdx.x * blockDim.x + threadIdx.x; i < chunk->size(); i += stride) {
+		(*chunk)[i] *= 2.0f;
+	}
+}
+
+kernelT get_kernel() {
+	return (kernelT)global_function;
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright: See LICENSE file that comes with this distribution
+ *
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "cupp/device.h"
+#include "cupp/jagged_vector.h"
+#include "cupp/kernel.h"
+
+#include "kernel_t.h"
+
+using namespace std;
+using namespace cupp;
+
+
+/**
+ * Prints all rows of @a j
+ */
+void print (const jagged_vector<int> &j) {
+	for (jagged_vector<int>::size_type r=0; r<j.size(); ++r) {
+		const jagged_vector<int>::const_row_span row = j.row(r);
+		cout << r << ": ";
+		for (const int* i=row.begin(); i!=row.end(); ++i) {
+			cout << *i << ", ";
+		}
+		cout << endl;
+	}
+}
+
+int main() {
+	// lets get a simple CUDA device up and running
+	device d;
+
+	// eight rows, row r has r elements
+	jagged_vector<int> rows;
+	for (int r=0; r<8; ++r) {
+		std::vector<int> row;
+		for (int i=0; i<r; ++i) {
+			row.push_back(i);
+		}
+		rows.push_back(row);
+	}
+
+	cout << "before the kernel call:" << endl;
+	print (rows);
+
+	dim3 block_dim (8);
+	dim3 grid_dim  (1);
+
+	// generate the kernel
+	kernel k (get_kernel(), grid_dim, block_dim );
+
+	// call the kernel, all rows are transfered with two copies
+	k (d, rows);
+
+	cout << "after the kernel call:" << endl;
+	print (rows);
+
+	// change one row, only this row is transfered by the next kernel call
+	{
+		jagged_vector<int>::row_span row = rows.row(3);
+		for (int* i=row.begin(); i!=row.end(); ++i) {
+			*i = 1;
+		}
+	}
+
+	k (d, rows);
+
+	cout << "after the next kernel call:" << endl;
+	print (rows);
+
+	// NDT
+	return EXIT_SUCCESS;
+}
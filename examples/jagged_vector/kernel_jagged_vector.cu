@@ -0,0 +1,30 @@
+/*
+ * Copyright: See LICENSE file that comes with this distribution
+ *
+ */
+
+#include "cupp/deviceT/jagged_vector.h"
+#include "kernel_t.h"
+
+// one thread per row, every element is replaced by the sum of its row
+__global__ void global_function (cupp::deviceT::jagged_vector<int> *j) {
+	if (threadIdx.x >= j->size()) {
+		return;
+	}
+
+	cupp::deviceT::jagged_vector<int>::row_span row = j->row(threadIdx.x);
+
+	typedef cupp::deviceT::jagged_vector<int>::size_type size_type;
+
+	int sum = 0;
+	for (size_type i=0; i<row.size(); ++i) {
+		sum += row[i];
+	}
+	for (size_type i=0; i<row.size(); ++i) {
+		row[i] = sum;
+	}
+}
+
+kernelT get_kernel() {
+	return (kernelT)global_function;
+}
@@ -0,0 +1,16 @@
+/*
+ * Copyright: See COPYING file that comes with this distribution
+ *
+ */
+
+#ifndef kernel_t_H
+#define kernel_t_H
+
+#include "cupp/deviceT/jagged_vector.h"
+
+typedef void(*kernelT)(cupp::deviceT::jagged_vector<int> *);
+
+// implemented in the .cu file
+kernelT get_kernel();
+
+#endif
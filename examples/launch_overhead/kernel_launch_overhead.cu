@@ -0,0 +1,17 @@
+/*
+ * Copyright: See LICENSE file that comes with this distribution
+ *
+ */
+
+#include "kernel_t.h"
+
+__global__ void global_function (const int a, const int b, const int c, const int d, const float e, const float f, const float g, int * result) {
+	// nearly nothing to do, so we only measure the launch
+	if (result != 0) {
+		*result = a + b + c + d + (int)(e + f + g);
+	}
+}
+
+kernelT get_kernel() {
+	return global_function;
+}
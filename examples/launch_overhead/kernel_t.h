@@ -0,0 +1,14 @@
+/*
+ * Copyright: See COPYING file that comes with this distribution
+ *
+ */
+
+#ifndef kernel_t_H
+#define kernel_t_H
+
+typedef void(*kernelT)(const int, const int, const int, const int, const float, const float, const float, int *);
+
+// implemented in the .cu file
+kernelT get_kernel();
+
+#endif
@@ -0,0 +1,110 @@
+/*
+ * Copyright: See LICENSE file that comes with this distribution
+ *
+ */
+
+#include <cstdlib>
+#include <iostream>
+
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+
+#include "cupp/device.h"
+#include "cupp/kernel.h"
+#include "cupp/typed_kernel.h"
+
+#include "kernel_t.h"
+
+using namespace std;
+using namespace cupp;
+
+// number of kernel launches per measurement
+const int launches = 100000;
+
+/**
+ * @return The current wall clock time
+ */
+boost::posix_time::ptime now() {
+	return boost::posix_time::microsec_clock::universal_time();
+}
+
+/**
+ * Waits for the launches started at @a start and prints their launches per second
+ */
+void print_result (const char* name, const device &d, const boost::posix_time::ptime start) {
+	d.sync();
+	const double seconds = (now() - start).total_microseconds() / 1e6;
+	cout << name << ": " << (seconds > 0 ? launches / seconds : 0) << " launches/s" << endl;
+}
+
+#if CUDART_VERSION < 10000
+/**
+ * Pushes @a a on the cuda function stack on its own, as done by CuPP before the arguments were packed
+ */
+template <typename T>
+void setup_argument (const T &a, size_t &offset) {
+	ALIGN_UP(offset, boost::alignment_of<T>::value);
+	cudaSetupArgument(&a, sizeof(T), offset);
+	offset += sizeof(T);
+}
+#endif
+
+int main() {
+	// lets get a simple CUDA device up and running
+	device d;
+
+	dim3 block_dim (1);
+	dim3 grid_dim  (1);
+
+	int *no_result = 0;
+	boost::posix_time::ptime start;
+
+#if CUDART_VERSION >= 7000
+	// the plain runtime launch, one pointer per argument
+	start = now();
+	for (int i=0; i<launches; ++i) {
+		int a = 1, b = 2, c = 3, e = 4;
+		float f = 5.0f, g = 6.0f, h = 7.0f;
+		void* args[] = { &a, &b, &c, &e, &f, &g, &h, &no_result };
+		cudaLaunchKernel((const void*)get_kernel(), grid_dim, block_dim, args, 0, 0);
+	}
+	print_result ("cudaLaunchKernel", d, start);
+#endif
+
+#if CUDART_VERSION < 10000
+	// one driver call per argument, as done by CuPP before the arguments were packed
+	start = now();
+	for (int i=0; i<launches; ++i) {
+		size_t offset = 0;
+		cudaConfigureCall(grid_dim, block_dim);
+		setup_argument(1, offset);
+		setup_argument(2, offset);
+		setup_argument(3, offset);
+		setup_argument(4, offset);
+		setup_argument(5.0f, offset);
+		setup_argument(6.0f, offset);
+		setup_argument(7.0f, offset);
+		setup_argument(no_result, offset);
+		cudaLaunch((const char*)get_kernel());
+	}
+	print_result ("one call per argument", d, start);
+#endif
+
+	// cupp::kernel
+	kernel k (get_kernel(), grid_dim, block_dim);
+	start = now();
+	for (int i=0; i<launches; ++i) {
+		k(d, 1, 2, 3, 4, 5.0f, 6.0f, 7.0f, no_result);
+	}
+	print_result ("cupp::kernel", d, start);
+
+	// cupp::typed_kernel
+	typed_kernel<kernelT> tk (get_kernel(), grid_dim, block_dim);
+	start = now();
+	for (int i=0; i<launches; ++i) {
+		tk(d, 1, 2, 3, 4, 5.0f, 6.0f, 7.0f, no_result);
+	}
+	print_result ("cupp::typed_kernel", d, start);
+
+	// NDT
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,23 @@
+/*
+ * Copyright: See LICENSE file that comes with this distribution
+ *
+ */
+
+#include "cupp/deviceT/soa_vector.h"
+#include "kernel_t.h"
+
+// one thread per particle, neighbouring threads access neighbouring positions and velocities
+__global__ void global_function (cupp::deviceT::soa_vector<particle> *p) {
+	if (threadIdx.x >= p->size()) {
+		return;
+	}
+
+	float* position = p->field<0>();
+	const float* velocity = p->field<1>();
+
+	position[threadIdx.x] += velocity[threadIdx.x];
+}
+
+kernelT get_kernel() {
+	return (kernelT)global_function;
+}
@@ -0,0 +1,28 @@
+/*
+ * Copyright: See COPYING file that comes with this distribution
+ *
+ */
+
+#ifndef kernel_t_H
+#define kernel_t_H
+
+#include "cupp/deviceT/soa_vector.h"
+
+struct particle {
+	float position;
+	float velocity;
+
+	// not needed on the device, never transfered
+	int id;
+};
+
+CUPP_SOA_FIELDS(particle, 2)
+CUPP_SOA_FIELD(particle, 0, float, position)
+CUPP_SOA_FIELD(particle, 1, float, velocity)
+
+typedef void(*kernelT)(cupp::deviceT::soa_vector<particle> *);
+
+// implemented in the .cu file
+kernelT get_kernel();
+
+#endif
@@ -0,0 +1,67 @@
+/*
+ * Copyright: See LICENSE file that comes with this distribution
+ *
+ */
+
+#include <cstdlib>
+#include <iostream>
+
+#include "cupp/device.h"
+#include "cupp/soa_vector.h"
+#include "cupp/kernel.h"
+
+#include "kernel_t.h"
+
+using namespace std;
+using namespace cupp;
+
+
+/**
+ * Prints all particles of @a p
+ */
+void print (const soa_vector<particle> &p) {
+	for (soa_vector<particle>::size_type i=0; i<p.size(); ++i) {
+		cout << p[i].id << ": " << p[i].position << " (" << p[i].velocity << ")" << endl;
+	}
+}
+
+int main() {
+	// lets get a simple CUDA device up and running
+	device d;
+
+	// eight particles
+	soa_vector<particle> particles;
+	for (int i=0; i<8; ++i) {
+		particle p;
+		p.position = 0.0f;
+		p.velocity = static_cast<float>(i);
+		p.id       = i;
+		particles.push_back(p);
+	}
+
+	cout << "before the kernel call:" << endl;
+	print (particles);
+
+	dim3 block_dim (8);
+	dim3 grid_dim  (1);
+
+	// generate the kernel
+	kernel k (get_kernel(), grid_dim, block_dim );
+
+	// call the kernel, one copy for the positions and one for the velocities
+	k (d, particles);
+
+	cout << "after the kernel call:" << endl;
+	print (particles);
+
+	// change the velocity of one particle, only the fields of this particle are transfered by the next kernel call
+	particles[3].field<1>() = -1.0f;
+
+	k (d, particles);
+
+	cout << "after the next kernel call:" << endl;
+	print (particles);
+
+	// NDT
+	return EXIT_SUCCESS;
+}
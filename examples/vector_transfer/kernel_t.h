@@ -0,0 +1,34 @@
+/*
+ * Copyright: See COPYING file that comes with this distribution
+ *
+ */
+
+#ifndef kernel_t_H
+#define kernel_t_H
+
+#include "cupp/deviceT/vector.h"
+
+namespace cupp {
+class device;
+}
+
+/**
+ * An int, which is transfered through kernel_call_traits::transform() like any class with type transformations.
+ * So cupp::vector can not copy it bit by bit, even though it could.
+ */
+struct boxed_int {
+	typedef boxed_int host_type;
+	typedef boxed_int device_type;
+
+	// only called on the host
+	boxed_int transform (const cupp::device &) { return *this; }
+
+	int value;
+};
+
+typedef void(*kernelT)(cupp::deviceT::vector<int> *, cupp::deviceT::vector<boxed_int> *);
+
+// implemented in the .cu file
+kernelT get_kernel();
+
+#endif
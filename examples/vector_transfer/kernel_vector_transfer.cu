@@ -0,0 +1,22 @@
+/*
+ * Copyright: See LICENSE file that comes with this distribution
+ *
+ */
+
+#include "cupp/deviceT/vector.h"
+#include "kernel_t.h"
+
+__global__ void global_function (cupp::deviceT::vector<int> *a, cupp::deviceT::vector<boxed_int> *b) {
+	const unsigned int i = blockIdx.x * blockDim.x + threadIdx.x;
+
+	if (i < a->size()) {
+		(*a)[i] += 1;
+	}
+	if (i < b->size()) {
+		(*b)[i].value += 1;
+	}
+}
+
+kernelT get_kernel() {
+	return (kernelT)global_function;
+}
@@ -0,0 +1,117 @@
+/*
+ * Copyright: See LICENSE file that comes with this distribution
+ *
+ */
+
+#include <cstdlib>
+#include <iostream>
+
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+
+#include "cupp/device.h"
+#include "cupp/vector.h"
+#include "cupp/kernel.h"
+
+#include "kernel_t.h"
+
+using namespace std;
+using namespace cupp;
+
+// number of elements per vector
+const int elements = 1 << 24;
+
+// number of round trips per measurement
+const int rounds = 20;
+
+/**
+ * @return The current wall clock time
+ */
+boost::posix_time::ptime now() {
+	return boost::posix_time::microsec_clock::universal_time();
+}
+
+/**
+ * Prints the throughput of the round trips started at @a start
+ */
+void print_result (const char* name, const boost::posix_time::ptime start) {
+	const double seconds = (now() - start).total_microseconds() / 1e6;
+	const double mb = double(rounds) * 2 * elements * sizeof(int) / (1024 * 1024);
+	cout << name << ": " << (seconds > 0 ? mb / seconds : 0) << " MB/s wall time (upload + download)" << endl;
+}
+
+/**
+ * Access the int stored in the elements of both vectors
+ */
+inline int get_value (const int v) { return v; }
+inline int get_value (const boxed_int &v) { return v.value; }
+
+inline void set_value (int &v, const int value) { v = value; }
+inline void set_value (boxed_int &v, const int value) { v.value = value; }
+
+/**
+ * Fills @a v on the host, lets the kernel change it and reads it back, @a rounds times
+ * @return The sum of all values read back
+ */
+template <typename T>
+long long round_trips (const device &d, kernel &k, cupp::vector<int> &ints, cupp::vector<boxed_int> &boxed, cupp::vector<T> &v) {
+	long long sum = 0;
+	for (int r=0; r<rounds; ++r) {
+		T value;
+		set_value (value, r);
+
+		// every element changed on the host, so the next kernel call transfers the whole vector
+		v.assign (elements, value);
+
+		k (d, ints, boxed);
+
+		// read everything back
+		const cupp::vector<T> &const_v = v;
+		for (typename cupp::vector<T>::const_iterator it = const_v.begin(); it != const_v.end(); ++it) {
+			sum += get_value (*it);
+		}
+	}
+	return sum;
+}
+
+int main() {
+	// lets get a simple CUDA device up and running
+	device d;
+
+	dim3 block_dim (256);
+	dim3 grid_dim  (elements / 256);
+
+	kernel k (get_kernel(), grid_dim, block_dim);
+
+	cupp::vector<int> ints;
+	cupp::vector<boxed_int> boxed;
+
+	// warm up, so the device memory is allocated before we measure
+	boxed_int zero;
+	set_value (zero, 0);
+
+	ints.assign (elements, 0);
+	boxed.assign (elements, zero);
+	k (d, ints, boxed);
+	d.sync();
+
+	// int is its own device type, copied straight from and to the std::vector
+	boxed.clear();
+	boost::posix_time::ptime start = now();
+	const long long int_sum = round_trips (d, k, ints, boxed, ints);
+	print_result ("bitwise (int)", start);
+
+	// boxed_int goes through transform() and a temporary std::vector in both directions
+	ints.clear();
+	boxed.assign (elements, zero);
+	start = now();
+	const long long boxed_sum = round_trips (d, k, ints, boxed, boxed);
+	print_result ("transformed (boxed_int)", start);
+
+	if (int_sum != boxed_sum) {
+		cout << "error: the results differ" << endl;
+		return EXIT_FAILURE;
+	}
+
+	// NDT
+	return EXIT_SUCCESS;
+}
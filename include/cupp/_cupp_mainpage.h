@@ -54,7 +54,9 @@
  *   - One is identical to the one offered by CUDA, unless that
  *     exceptions are thrown when an error occurs instead of returning an error code.
  *     To ease the development with this basic approach, a boost library-compliant
- *     shared pointer for global memory is supplied.
+ *     shared pointer for global memory is supplied. All allocations are served by a
+ *     per device caching allocator (cupp::caching_allocator), so freed blocks are reused
+ *     without calling cudaMalloc/cudaFree again.
  *   - The second type of memory management uses a class called cupp::memory1d.
  *     Objects of this class represent a linear block of global memory. The memory is
  *     allocated when the object is created and freed when the object is destroyed.
@@ -63,14 +65,32 @@
  *   The CuPP kernel call is implemented by a C++ functor (cupp::kernel), which
  *   adds a call by reference like semantic to basic CUDA kernel calls. This can be used
  *   to pass datastructures like cupp::vector to a kernel, so the device can modify them.
+ *   A kernel can be launched in a cupp::stream, the transfers of its parameters are then
+ *   enqueued in the same stream, so independent kernel chains can run concurrently.
+ *   cupp::typed_kernel offers the same call semantic, but maps the arguments to the kernel
+ *   parameters at compile time. Its calls need no type-erased argument list and wrong argument types
+ *   are reported by the compiler.
+ *   Parameters which do not fit on the cuda function stack can be declared as cupp::deviceT::spilled,
+ *   they are then passed in a parameter block in global memory.
+ *   With lazy write-back (cupp::kernel::set_lazy_write_back()) a call does not wait for the new values
+ *   of plain structs passed by reference and guarded by a cupp::write_back_scope, they are fetched when needed
+ *   (cupp::fetch(), cupp::device::sync(), the end of the scope).
+ *   Arguments can be wrapped by cupp::in() or cupp::out() to tell how the kernel accesses them, so data only read
+ *   is not transferred back and data overwritten is not transferred to the device.
+ *   cupp::kernel_profiler times the launches on the device with events and reports call count,
+ *   total/min/max/percentile time and the grid and block sizes per kernel.
  * - <b>Support for classes</b> \n
  *   Using a technique called "type transformations" generic C++ classes can easily be transferred to
  *   and from device memory.
  * - <b>Data structures</b> \n
- *   Currently only a std::vector wrapper offering automatic memory
+ *   A std::vector wrapper offering automatic memory
  *   management is supplied. This class also implements a feature called lazy memory copying, to
- *   minimize any memory transfers between device and host memory. Currently no other datastructures are
- *   supplied, but can be added with ease.
+ *   minimize any memory transfers between device and host memory. cupp::jagged_vector stores rows of
+ *   different length in two such vectors, so any number of rows is transferred with two copies.
+ *   cupp::soa_vector stores every field of a struct declared with CUPP_SOA_FIELD in its own
+ *   device array. cupp::for_each_chunk runs an element-wise kernel on a vector bigger than the
+ *   memory of the device, one chunk after another.
+ *   Other datastructures can be added with ease.
  *
  * A document describing all functionalities in detail, can be found in the references section.
  * 
@@ -0,0 +1,155 @@
+/*
+ * Copyright: See LICENSE file that comes with this distribution
+ *
+ */
+
+#ifndef CUPP_access_H
+#define CUPP_access_H
+
+#if defined(__CUDACC__)
+#error "Not compatible with CUDA. Don't compile with nvcc."
+#endif
+
+// CUPP
+#include "cupp/common.h"
+
+// BOOST
+#include <boost/static_assert.hpp>
+
+
+namespace cupp {
+
+/**
+ * @brief How a kernel accesses an argument
+ */
+enum access_mode {
+	/**
+	 * The kernel reads and writes the argument, the default
+	 */
+	read_write,
+
+	/**
+	 * The kernel only reads the argument, see @c cupp::in()
+	 */
+	read_only,
+
+	/**
+	 * The kernel overwrites the argument without reading it, see @c cupp::out()
+	 */
+	write_only
+};
+
+
+/**
+ * @class uses_access_mode
+ * @brief true if the data structure @a T skips transfers depending on how the kernel accesses it.
+ *        Only such a data structure can be passed to @c cupp::out(), no other one is told the @c access_mode.
+ *        Specialized by @c cupp::vector, @c cupp::soa_vector and @c cupp::jagged_vector.
+ */
+template <typename T>
+struct uses_access_mode {
+	enum { value = false };
+};
+
+
+/**
+ * @class access_argument
+ * @platform Host only
+ * @brief An argument passed to @c cupp::kernel or @c cupp::typed_kernel together with the way the kernel accesses it.
+ *        Created by @c cupp::in() and @c cupp::out().
+ */
+template <typename T, access_mode mode>
+class access_argument {
+	public:
+		explicit access_argument (const T &value) : value_(value) {}
+
+		/**
+		 * @return The argument
+		 */
+		const T& get() const { return value_; }
+
+	private:
+		const T &value_;
+};
+
+
+/**
+ * @brief Marks @a value as only read by the kernel it is passed to. Even if the kernel expects a non-const
+ *        reference, @a value is not written back to the host and its host data stays valid.
+ * @example k (d, cupp::in(input), output);
+ */
+template <typename T>
+inline access_argument<T, read_only> in (const T &value) {
+	return access_argument<T, read_only>(value);
+}
+
+/**
+ * @brief Marks @a value as overwritten by the kernel it is passed to. Its data is not transfered to the device,
+ *        only memory is allocated for it.
+ * @warning The elements not written by the kernel are undefined afterwards.
+ * @example k (d, input, cupp::out(output));
+ */
+template <typename T>
+inline access_argument<T, write_only> out (T &value) {
+	// any other type would transfer its data anyway
+	BOOST_STATIC_ASSERT(( uses_access_mode<T>::value ));
+	return access_argument<T, write_only>(value);
+}
+
+
+namespace impl {
+
+/**
+ * @return How the kernel currently called accesses the argument being transfered, always @c read_write
+ *         unless the argument is a data structure in @c uses_access_mode. Only read through @c take_access().
+ */
+inline access_mode& current_access() {
+	static access_mode current = read_write;
+	return current;
+}
+
+/**
+ * @return How the kernel currently called accesses the argument being transfered
+ * Resets @c current_access() to @c read_write, so the mode only applies to the argument itself. The data structures
+ * transfered as part of it (e.g. the elements of a vector or the vectors of a jagged_vector) are transfered as usual,
+ * unless the argument passes the mode on with an @c access_guard.
+ * Called once by every data structure in @c uses_access_mode at the start of its transfer.
+ */
+inline access_mode take_access() {
+	const access_mode mode = current_access();
+	current_access() = read_write;
+	return mode;
+}
+
+/**
+ * @class access_guard
+ * @brief Sets @c current_access() for its lifetime
+ */
+class access_guard {
+	public:
+		explicit access_guard (const access_mode mode) : old_(current_access()) {
+			current_access() = mode;
+		}
+
+		/**
+		 * @brief Sets @c current_access() to @a mode for the transfer of a @a T, which is only told the mode if it
+		 *        is in @c uses_access_mode. Any other type (e.g. a struct of several vectors) is transfered as usual.
+		 */
+		template <typename T>
+		static access_mode for_type (const access_mode mode) {
+			return uses_access_mode<T>::value ? mode : read_write;
+		}
+
+		~access_guard() {
+			current_access() = old_;
+		}
+
+	private:
+		access_mode old_;
+};
+
+} // namespace impl
+
+} // namespace cupp
+
+#endif
@@ -0,0 +1,826 @@
+/*
+ * Copyright: See LICENSE file that comes with this distribution
+ *
+ */
+
+#ifndef CUPP_caching_allocator_H
+#define CUPP_caching_allocator_H
+
+#if defined(__CUDACC__)
+#error "Not compatible with CUDA. Don't compile with nvcc."
+#endif
+
+// CUPP
+#include "cupp/common.h"
+#include "cupp/spill_registry.h"
+#include "cupp/stream.h"
+#include "cupp/exception/cuda_runtime_error.h"
+
+// STD
+#include <cstddef> // Include std::size_t
+#include <algorithm> // Include std::max
+#include <map>
+#include <ostream>
+#include <string>
+#include <utility> // Include std::make_pair
+#include <vector>
+
+// CUDA
+#include <cuda_runtime.h>
+
+
+namespace cupp {
+
+namespace impl {
+
+/**
+ * @return The name of the data structure currently allocating global memory, 0 if unknown.
+ *         Used by the @c caching_allocator to count the memory per data structure.
+ */
+inline const char*& current_allocation_tag() {
+	static const char* current = 0;
+	return current;
+}
+
+/**
+ * @class allocation_tag
+ * @brief Sets @c current_allocation_tag() for its lifetime. The outermost data structure names the allocation,
+ *        e.g. the memory of a @c memory1d used by a @c vector is counted for the vector.
+ */
+class allocation_tag {
+	public:
+		explicit allocation_tag (const char* tag) : old_(current_allocation_tag()) {
+			if (old_ == 0) {
+				current_allocation_tag() = tag;
+			}
+		}
+
+		~allocation_tag() {
+			current_allocation_tag() = old_;
+		}
+
+	private:
+		const char* old_;
+};
+
+} // namespace impl
+
+
+/**
+ * @class caching_allocator
+ * @platform Host only
+ * @brief A per device cache of global memory blocks sitting between cupp::malloc / cupp::free and cudaMalloc / cudaFree.
+ *
+ * Requests are rounded up to a power of two size class (at least @c min_block_size bytes). Freed blocks are
+ * not returned to the driver, but put into the free list of their size class and handed out again by the next
+ * request of the same class on the same device. Blocks bigger than @c max_block_size are not cached at all.
+ * A kernel may still use a block when it is freed, so an event is recorded in the stream the block has been used in
+ * when the block is put into the cache and the block is only handed out again after the event completed. A block is
+ * used in the stream current at its allocation and in all streams passed to @c use_in_stream(). Work in the default
+ * stream is finished before later work in any other stream, only blocks used in more than one other stream record their
+ * event in the default stream, which waits for all other streams.
+ * If a cudaMalloc fails, all cached blocks of the device are released and the allocation is retried. If it still fails,
+ * the least recently used data structures on the device are spilled (see @c spill_registry) until it succeeds.
+ * Every allocation is counted per device, per size class and per data structure (see @c impl::allocation_tag).
+ *
+ * @warning This class is not thread safe, just like the rest of CuPP.
+ */
+class caching_allocator {
+	public:
+		typedef int id_t;
+
+		/**
+		 * @brief The smallest size class in bytes
+		 */
+		static const std::size_t min_block_size = 256;
+
+		/**
+		 * @brief The biggest size class in bytes, bigger blocks are passed directly to the driver
+		 */
+		static const std::size_t max_block_size = std::size_t(1) << 26;
+
+		/**
+		 * @struct tag_statistics
+		 * @brief The allocation statistics of one kind of data structure on one device
+		 */
+		struct tag_statistics {
+			tag_statistics() : allocations(0), bytes_in_use(0), peak_bytes_in_use(0) {}
+
+			/**
+			 * Number of allocations
+			 */
+			std::size_t allocations;
+
+			/**
+			 * Bytes currently handed out
+			 */
+			std::size_t bytes_in_use;
+
+			/**
+			 * The maximum of @a bytes_in_use
+			 */
+			std::size_t peak_bytes_in_use;
+		};
+
+		/**
+		 * @struct statistics
+		 * @brief The allocation statistics of one device
+		 */
+		struct statistics {
+			statistics() : driver_allocations(0), driver_frees(0), cache_hits(0), cache_misses(0), bytes_in_use(0), bytes_cached(0), peak_bytes_in_use(0), peak_bytes_held(0), allocations(0), large_allocations(0) {}
+
+			/**
+			 * Number of calls to cudaMalloc
+			 */
+			std::size_t driver_allocations;
+
+			/**
+			 * Number of calls to cudaFree
+			 */
+			std::size_t driver_frees;
+
+			/**
+			 * Number of allocations served from the cache
+			 */
+			std::size_t cache_hits;
+
+			/**
+			 * Number of allocations that needed a new block from the driver
+			 */
+			std::size_t cache_misses;
+
+			/**
+			 * Bytes currently handed out to the user (including the rounding to the size class)
+			 */
+			std::size_t bytes_in_use;
+
+			/**
+			 * Bytes currently held in the free lists
+			 */
+			std::size_t bytes_cached;
+
+			/**
+			 * The maximum of @a bytes_in_use, the high-water mark of the device
+			 */
+			std::size_t peak_bytes_in_use;
+
+			/**
+			 * The maximum of @a bytes_in_use + @a bytes_cached, the most device memory we have taken from the driver
+			 */
+			std::size_t peak_bytes_held;
+
+			/**
+			 * Number of allocations
+			 */
+			std::size_t allocations;
+
+			/**
+			 * Number of allocations per size class, the first class is @c min_block_size bytes
+			 */
+			std::vector<std::size_t> allocations_by_size_class;
+
+			/**
+			 * Number of allocations bigger than @c max_block_size
+			 */
+			std::size_t large_allocations;
+
+			/**
+			 * The statistics per data structure, allocations without a tag are counted as "other"
+			 */
+			std::map<std::string, tag_statistics> by_tag;
+		};
+
+	public: /***  CONSTRUCTORS & DESTRUCTORS  ***/
+		/**
+		 * @return The one and only allocator
+		 */
+		static caching_allocator& instance() {
+			static caching_allocator allocator;
+			return allocator;
+		}
+
+		/**
+		 * @brief Returns the cached blocks to the driver, errors are ignored as the context may already be gone
+		 */
+		~caching_allocator();
+
+	public:
+		/**
+		 * @brief Allocates at least @a size_in_b bytes of global memory on the current device
+		 * @exception cuda_runtime_error
+		 */
+		void* allocate (const std::size_t size_in_b);
+
+		/**
+		 * @brief Gives @a device_pointer back to the cache
+		 * @note Pointers not allocated by @c allocate() are passed directly to cudaFree.
+		 * @exception cuda_runtime_error
+		 */
+		void deallocate (void* device_pointer);
+
+		/**
+		 * @brief Tells the cache that work enqueued in @a s uses @a device_pointer, so its block is handed out again
+		 *        only after that work has been done
+		 * @note Pointers not allocated by @c allocate() are ignored.
+		 */
+		void use_in_stream (void* device_pointer, const stream &s);
+
+		/**
+		 * @brief Frees cached blocks of the current device until at most @a max_cached_bytes are cached
+		 * @exception cuda_runtime_error
+		 */
+		void trim (const std::size_t max_cached_bytes);
+
+		/**
+		 * @brief Frees all cached blocks of the current device
+		 * @exception cuda_runtime_error
+		 */
+		void release ();
+
+		/**
+		 * @brief Frees all cached blocks of the device @a device_id
+		 * @exception cuda_runtime_error
+		 */
+		void release (const id_t device_id);
+
+		/**
+		 * @brief Frees all cached blocks of the device @a device_id and forgets about all blocks still in use on it
+		 * @note Must be called before the context of the device is destroyed, blocks freed later on are passed
+		 *       directly to cudaFree.
+		 */
+		void device_reset (const id_t device_id);
+
+		/**
+		 * @brief Sets the upper limit of cached bytes per device, @c deallocate() trims the cache to it
+		 */
+		void set_max_cached_bytes (const std::size_t max_cached_bytes) { max_cached_bytes_ = max_cached_bytes; }
+
+		/**
+		 * @return The upper limit of cached bytes per device
+		 */
+		std::size_t max_cached_bytes () const { return max_cached_bytes_; }
+
+		/**
+		 * @brief Enables or disables caching, disabling releases all cached blocks of the current device
+		 */
+		void set_enabled (const bool enabled);
+
+		/**
+		 * @return true if freed blocks are cached
+		 */
+		bool enabled () const { return enabled_; }
+
+		/**
+		 * @return The statistics of the current device
+		 */
+		statistics stats () const;
+
+		/**
+		 * @return The statistics of the device @a device_id
+		 */
+		statistics stats (const id_t device_id) const;
+
+		/**
+		 * @brief Writes the statistics of the device to @a out after every @a interval allocations on it,
+		 *        passing 0 as @a out stops it
+		 */
+		void set_report (std::ostream *out, const std::size_t interval = 1000) { report_out_ = out; report_interval_ = interval; }
+
+	private:
+		/**
+		 * @brief Information about a block handed out to the user
+		 */
+		struct block {
+			id_t device;
+			int size_class;
+			std::size_t size;
+
+			/**
+			 * The entry of the data structure owning the block in the statistics of its device
+			 */
+			tag_statistics* tag;
+
+			/**
+			 * The stream the block has been used in, the default stream if it has been used in more than one
+			 */
+			stream used_in;
+
+			/**
+			 * true if the block has been used in more than one stream
+			 */
+			bool several_streams;
+		};
+
+		/**
+		 * @brief A block in the cache
+		 */
+		struct cached_block {
+			void* pointer;
+
+			/**
+			 * Recorded when the block has been freed, the block can be reused when it completed
+			 */
+			cudaEvent_t freed;
+		};
+
+		/**
+		 * @brief All data we store per device
+		 */
+		struct device_pool {
+			/**
+			 * One free list per size class
+			 */
+			std::vector< std::vector<cached_block> > free_lists;
+
+			/**
+			 * Events not in use, created on this device
+			 */
+			std::vector<cudaEvent_t> free_events;
+
+			statistics stats;
+
+			/**
+			 * The entries of @a stats.by_tag by the address of their tag, so no std::string is built per allocation
+			 */
+			std::map<const char*, tag_statistics*> tags;
+		};
+
+		caching_allocator() : enabled_(true), max_cached_bytes_(std::size_t(-1)), report_out_(0), report_interval_(0) {}
+
+		// not copyable
+		caching_allocator (const caching_allocator&);
+		caching_allocator& operator= (const caching_allocator&);
+
+		/**
+		 * @return The size class for @a size_in_b or -1 if the block is too big to be cached
+		 */
+		static int size_class (const std::size_t size_in_b);
+
+		/**
+		 * @return The size in bytes of the size class @a c
+		 */
+		static std::size_t class_size (const int c) { return min_block_size << c; }
+
+		/**
+		 * @return The id of the current device
+		 */
+		static id_t current_device ();
+
+		/**
+		 * @brief Frees blocks of @a pool on device @a device_id until at most @a max_cached_bytes are cached
+		 */
+		void trim (device_pool &pool, const id_t device_id, const std::size_t max_cached_bytes);
+
+		/**
+		 * @brief Calls cudaMalloc, on failure the cache of @a device_id is released and data structures are spilled
+		 *        until the call succeeds
+		 */
+		void* driver_malloc (device_pool &pool, const id_t device_id, const std::size_t size_in_b);
+
+		/**
+		 * @brief Calls cudaFree on device @a device_id
+		 */
+		void driver_free (device_pool &pool, const id_t device_id, void* device_pointer);
+
+		/**
+		 * @return A cached block of the size class @a c of @a pool no longer used by the device, 0 if there is none
+		 * @exception cuda_runtime_error
+		 */
+		void* take_cached_block (device_pool &pool, const int c);
+
+		/**
+		 * @return An event recorded in the stream @a b has been used in
+		 * @exception cuda_runtime_error
+		 */
+		cudaEvent_t record_free_event (device_pool &pool, const block &b);
+
+		/**
+		 * @return The entry of @a tag in the statistics of @a pool
+		 */
+		static tag_statistics* find_tag (device_pool &pool, const char* tag);
+
+		/**
+		 * @brief Counts the allocation of @a b in the statistics of @a pool
+		 */
+		void count_allocation (device_pool &pool, const block &b);
+
+		/**
+		 * @brief Counts that @a b has been given back in the statistics of @a pool
+		 */
+		void count_deallocation (device_pool &pool, const block &b);
+
+	private:
+		/**
+		 * true means freed blocks are cached
+		 */
+		bool enabled_;
+
+		/**
+		 * Upper limit of cached bytes per device
+		 */
+		std::size_t max_cached_bytes_;
+
+		/**
+		 * Our pools, one per device
+		 */
+		std::map<id_t, device_pool> pools_;
+
+		/**
+		 * All blocks currently handed out
+		 */
+		std::map<void*, block> live_blocks_;
+
+		/**
+		 * The statistics are written here, if not 0
+		 */
+		std::ostream *report_out_;
+
+		/**
+		 * The statistics are written after this number of allocations
+		 */
+		std::size_t report_interval_;
+};
+
+
+/**
+ * @brief Writes @a stats in a human readable form to @a out
+ */
+inline std::ostream& operator<< (std::ostream &out, const caching_allocator::statistics &stats) {
+	out << "bytes in use: " << stats.bytes_in_use << " (peak " << stats.peak_bytes_in_use << "), cached: " << stats.bytes_cached << ", peak held: " << stats.peak_bytes_held << "\n";
+	out << "allocations: " << stats.allocations << " (cache hits " << stats.cache_hits << ", cudaMalloc " << stats.driver_allocations << ", cudaFree " << stats.driver_frees << ")\n";
+
+	out << "allocations by size class:";
+	for (std::size_t c = 0; c < stats.allocations_by_size_class.size(); ++c) {
+		if (stats.allocations_by_size_class[c] != 0) {
+			out << " " << (caching_allocator::min_block_size << c) << "B: " << stats.allocations_by_size_class[c];
+		}
+	}
+	out << " large: " << stats.large_allocations << "\n";
+
+	for (std::map<std::string, caching_allocator::tag_statistics>::const_iterator it = stats.by_tag.begin(); it != stats.by_tag.end(); ++it) {
+		out << it->first << ": " << it->second.bytes_in_use << " bytes in use (peak " << it->second.peak_bytes_in_use << "), " << it->second.allocations << " allocations\n";
+	}
+
+	return out;
+}
+
+
+inline caching_allocator::~caching_allocator() {
+	for (std::map<id_t, device_pool>::iterator it = pools_.begin(); it != pools_.end(); ++it) {
+		for (std::size_t c = 0; c < it->second.free_lists.size(); ++c) {
+			for (std::size_t i = 0; i < it->second.free_lists[c].size(); ++i) {
+				cudaFree (it->second.free_lists[c][i].pointer);
+				cudaEventDestroy (it->second.free_lists[c][i].freed);
+			}
+		}
+		for (std::size_t i = 0; i < it->second.free_events.size(); ++i) {
+			cudaEventDestroy (it->second.free_events[i]);
+		}
+	}
+}
+
+
+inline int caching_allocator::size_class (const std::size_t size_in_b) {
+	int c = 0;
+	std::size_t s = min_block_size;
+
+	while (s < size_in_b) {
+		if (s == max_block_size) {
+			return -1;
+		}
+		s <<= 1;
+		++c;
+	}
+
+	return c;
+}
+
+
+inline caching_allocator::id_t caching_allocator::current_device () {
+	id_t cur_device = 0;
+	cudaGetDevice(&cur_device);
+	return cur_device;
+}
+
+
+inline void* caching_allocator::driver_malloc (device_pool &pool, const id_t device_id, const std::size_t size_in_b) {
+	void* temp;
+	cudaError_t error = cudaMalloc( &temp, size_in_b );
+	if (error != cudaSuccess) {
+		// the retry may succeed, so the error must not show up in the next error check
+		cudaGetLastError();
+
+		// maybe our cache is in the way, give everything back and try again
+		trim (pool, device_id, 0);
+
+		while ((error = cudaMalloc( &temp, size_in_b )) != cudaSuccess) {
+			cudaGetLastError();
+
+			// spill the least recently used data structures, their memory ends up in our cache
+			if (spill_registry::instance().spill(device_id, size_in_b) == 0) {
+				throw exception::cuda_runtime_error(error);
+			}
+			trim (pool, device_id, 0);
+		}
+	}
+	++pool.stats.driver_allocations;
+	return temp;
+}
+
+
+inline void caching_allocator::driver_free (device_pool &pool, const id_t device_id, void* device_pointer) {
+	const id_t cur_device = current_device();
+	if (cur_device != device_id) {
+		cudaSetDevice (device_id);
+	}
+
+	const cudaError_t error = cudaFree (device_pointer);
+
+	if (cur_device != device_id) {
+		cudaSetDevice (cur_device);
+	}
+
+	if (error != cudaSuccess) {
+		throw exception::cuda_runtime_error(cudaGetLastError());
+	}
+	++pool.stats.driver_frees;
+}
+
+
+inline void* caching_allocator::take_cached_block (device_pool &pool, const int c) {
+	if (static_cast<std::size_t>(c) >= pool.free_lists.size()) {
+		return 0;
+	}
+	std::vector<cached_block> &free_list = pool.free_lists[c];
+
+	// the most recently freed block is the most likely to still be in use, but the best one for the caches
+	for (std::size_t i = free_list.size(); i > 0; --i) {
+		const cached_block cached = free_list[i-1];
+
+		const cudaError_t error = cudaEventQuery (cached.freed);
+		if (error == cudaErrorNotReady) {
+			continue;
+		}
+		if (error != cudaSuccess) {
+			throw exception::cuda_runtime_error(error);
+		}
+
+		free_list.erase (free_list.begin() + (i-1));
+		pool.free_events.push_back(cached.freed);
+		return cached.pointer;
+	}
+
+	return 0;
+}
+
+
+inline cudaEvent_t caching_allocator::record_free_event (device_pool &pool, const block &b) {
+	const id_t cur_device = current_device();
+	if (cur_device != b.device) {
+		cudaSetDevice (b.device);
+	}
+
+	cudaEvent_t e = 0;
+	cudaError_t error = cudaSuccess;
+	if (!pool.free_events.empty()) {
+		e = pool.free_events.back();
+		pool.free_events.pop_back();
+	} else {
+		error = cudaEventCreateWithFlags (&e, cudaEventDisableTiming);
+	}
+
+	if (error == cudaSuccess) {
+		error = cudaEventRecord (e, b.used_in.get());
+		if (error != cudaSuccess) {
+			pool.free_events.push_back(e);
+		}
+	}
+
+	if (cur_device != b.device) {
+		cudaSetDevice (cur_device);
+	}
+
+	if (error != cudaSuccess) {
+		throw exception::cuda_runtime_error(error);
+	}
+	return e;
+}
+
+
+inline void* caching_allocator::allocate (const std::size_t size_in_b) {
+	const id_t dev = current_device();
+	device_pool &pool = pools_[dev];
+
+	block b;
+	b.device     = dev;
+	b.size_class = size_class(size_in_b);
+	b.size       = b.size_class == -1 ? size_in_b : class_size(b.size_class);
+	b.tag        = find_tag(pool, impl::current_allocation_tag() == 0 ? "other" : impl::current_allocation_tag());
+	b.used_in    = impl::current_stream();
+	b.several_streams = false;
+
+	void* returnee = 0;
+
+	if (b.size_class != -1 && (returnee = take_cached_block(pool, b.size_class)) != 0) {
+		pool.stats.bytes_cached -= b.size;
+		++pool.stats.cache_hits;
+	} else {
+		returnee = driver_malloc(pool, dev, b.size);
+		++pool.stats.cache_misses;
+	}
+
+	count_allocation(pool, b);
+	live_blocks_[returnee] = b;
+
+	return returnee;
+}
+
+
+inline caching_allocator::tag_statistics* caching_allocator::find_tag (device_pool &pool, const char* tag) {
+	std::map<const char*, tag_statistics*>::iterator it = pool.tags.find(tag);
+	if (it == pool.tags.end()) {
+		// the entries of a std::map are never moved
+		it = pool.tags.insert(std::make_pair(tag, &pool.stats.by_tag[tag])).first;
+	}
+	return it->second;
+}
+
+
+inline void caching_allocator::count_allocation (device_pool &pool, const block &b) {
+	statistics &stats = pool.stats;
+
+	stats.bytes_in_use += b.size;
+	stats.peak_bytes_in_use = std::max (stats.peak_bytes_in_use, stats.bytes_in_use);
+	stats.peak_bytes_held = std::max (stats.peak_bytes_held, stats.bytes_in_use + stats.bytes_cached);
+	++stats.allocations;
+
+	if (b.size_class == -1) {
+		++stats.large_allocations;
+	} else {
+		if (stats.allocations_by_size_class.size() <= static_cast<std::size_t>(b.size_class)) {
+			stats.allocations_by_size_class.resize(b.size_class+1, 0);
+		}
+		++stats.allocations_by_size_class[b.size_class];
+	}
+
+	tag_statistics &tag = *b.tag;
+	tag.bytes_in_use += b.size;
+	tag.peak_bytes_in_use = std::max (tag.peak_bytes_in_use, tag.bytes_in_use);
+	++tag.allocations;
+
+	if (report_out_ != 0 && report_interval_ != 0 && stats.allocations % report_interval_ == 0) {
+		*report_out_ << "CuPP device " << b.device << " memory:\n" << stats;
+	}
+}
+
+
+inline void caching_allocator::count_deallocation (device_pool &pool, const block &b) {
+	pool.stats.bytes_in_use -= b.size;
+	b.tag->bytes_in_use -= b.size;
+}
+
+
+inline void caching_allocator::deallocate (void* device_pointer) {
+	if (device_pointer == 0) {
+		return;
+	}
+
+	std::map<void*, block>::iterator it = live_blocks_.find(device_pointer);
+
+	if (it == live_blocks_.end()) {
+		// not one of ours
+		if (cudaFree(device_pointer) != cudaSuccess) {
+			throw exception::cuda_runtime_error(cudaGetLastError());
+		}
+		return;
+	}
+
+	const block b = it->second;
+	live_blocks_.erase(it);
+
+	device_pool &pool = pools_[b.device];
+	count_deallocation(pool, b);
+
+	if (!enabled_ || b.size_class == -1) {
+		driver_free(pool, b.device, device_pointer);
+		return;
+	}
+
+	cached_block cached;
+	cached.pointer = device_pointer;
+	cached.freed   = record_free_event(pool, b);
+
+	if (pool.free_lists.size() <= static_cast<std::size_t>(b.size_class)) {
+		pool.free_lists.resize(b.size_class+1);
+	}
+	pool.free_lists[b.size_class].push_back(cached);
+	pool.stats.bytes_cached += b.size;
+
+	if (pool.stats.bytes_cached > max_cached_bytes_) {
+		trim (pool, b.device, max_cached_bytes_);
+	}
+}
+
+
+inline void caching_allocator::use_in_stream (void* device_pointer, const stream &s) {
+	std::map<void*, block>::iterator it = live_blocks_.find(device_pointer);
+	if (it == live_blocks_.end()) {
+		return;
+	}
+
+	block &b = it->second;
+	if (s.get() == 0 || b.several_streams || b.used_in.get() == s.get()) {
+		return;
+	}
+
+	if (b.used_in.get() == 0) {
+		b.used_in = s;
+	} else {
+		// work in two streams is only ordered by the default stream
+		b.used_in = stream();
+		b.several_streams = true;
+	}
+}
+
+
+inline void caching_allocator::trim (device_pool &pool, const id_t device_id, const std::size_t max_cached_bytes) {
+	// free the biggest blocks first
+	for (int c = static_cast<int>(pool.free_lists.size())-1; c >= 0 && pool.stats.bytes_cached > max_cached_bytes; --c) {
+		std::vector<cached_block> &free_list = pool.free_lists[c];
+
+		while (!free_list.empty() && pool.stats.bytes_cached > max_cached_bytes) {
+			// cudaFree waits for the device, the event is not needed
+			driver_free(pool, device_id, free_list.back().pointer);
+			pool.free_events.push_back(free_list.back().freed);
+			free_list.pop_back();
+			pool.stats.bytes_cached -= class_size(c);
+		}
+	}
+}
+
+
+inline void caching_allocator::trim (const std::size_t max_cached_bytes) {
+	const id_t dev = current_device();
+	trim (pools_[dev], dev, max_cached_bytes);
+}
+
+
+inline void caching_allocator::release () {
+	trim (0);
+}
+
+
+inline void caching_allocator::release (const id_t device_id) {
+	std::map<id_t, device_pool>::iterator it = pools_.find(device_id);
+	if (it != pools_.end()) {
+		trim (it->second, device_id, 0);
+	}
+}
+
+
+inline void caching_allocator::device_reset (const id_t device_id) {
+	release (device_id);
+
+	std::map<id_t, device_pool>::iterator pool = pools_.find(device_id);
+	if (pool != pools_.end()) {
+		for (std::size_t i = 0; i < pool->second.free_events.size(); ++i) {
+			cudaEventDestroy (pool->second.free_events[i]);
+		}
+	}
+
+	for (std::map<void*, block>::iterator it = live_blocks_.begin(); it != live_blocks_.end(); ) {
+		if (it->second.device == device_id) {
+			live_blocks_.erase(it++);
+		} else {
+			++it;
+		}
+	}
+
+	pools_.erase(device_id);
+}
+
+
+inline void caching_allocator::set_enabled (const bool enabled) {
+	enabled_ = enabled;
+	if (!enabled_) {
+		release();
+	}
+}
+
+
+inline caching_allocator::statistics caching_allocator::stats () const {
+	return stats (current_device());
+}
+
+
+inline caching_allocator::statistics caching_allocator::stats (const id_t device_id) const {
+	std::map<id_t, device_pool>::const_iterator it = pools_.find(device_id);
+	if (it == pools_.end()) {
+		return statistics();
+	}
+	return it->second.stats;
+}
+
+} // namespace cupp
+
+#endif
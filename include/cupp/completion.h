@@ -0,0 +1,192 @@
+/*
+ * Copyright: See LICENSE file that comes with this distribution
+ *
+ */
+
+#ifndef CUPP_completion_H
+#define CUPP_completion_H
+
+#if defined(__CUDACC__)
+#error "Not compatible with CUDA. Don't compile with nvcc."
+#endif
+
+// CUPP
+#include "cupp/common.h"
+#include "cupp/staging_pool.h"
+#include "cupp/exception/cuda_runtime_error.h"
+
+// STD
+#include <cstddef> // Include std::size_t
+#include <cstring> // Include std::memcpy
+
+// BOOST
+#include <boost/any.hpp>
+#include <boost/shared_ptr.hpp>
+
+// CUDA
+#include <cuda_runtime.h>
+
+
+namespace cupp {
+
+/**
+ * @class completion
+ * @platform Host only
+ * @brief A handle to an asynchronous operation, e.g. returned by the @c cupp::copy_*_async functions.
+ *
+ * The handle keeps everything the operation needs alive (the staging buffer and the device memory)
+ * until the operation has finished. Copies of a completion share the same operation.
+ * If the last copy is destroyed, it waits for the operation.
+ * A default constructed completion is always ready.
+ */
+class completion {
+	public:
+		/**
+		 * @brief Creates a completion which is already completed
+		 */
+		completion() {}
+
+		/**
+		 * @brief Creates a completion for all work enqueued in @a stream up to now
+		 * @param stream The stream the operation has been enqueued in
+		 * @exception cuda_runtime_error
+		 */
+		explicit completion (cudaStream_t stream) : state_(new state()) {
+			state_->record(stream);
+		}
+
+		/**
+		 * @return true if the operation has finished
+		 * @exception cuda_runtime_error
+		 */
+		bool ready() const {
+			if (state_.get() == 0 || state_->finished) {
+				return true;
+			}
+
+			const cudaError_t error = cudaEventQuery(state_->event);
+			if (error == cudaSuccess) {
+				state_->finish();
+				return true;
+			}
+			if (error != cudaErrorNotReady) {
+				throw exception::cuda_runtime_error(error);
+			}
+			return false;
+		}
+
+		/**
+		 * @brief Blocks until the operation has finished
+		 * @exception cuda_runtime_error
+		 */
+		void wait() const {
+			if (state_.get() != 0) {
+				state_->wait();
+			}
+		}
+
+		/**
+		 * @brief Makes the work enqueued in @a stream afterwards wait for the operation, without blocking the host
+		 * @exception cuda_runtime_error
+		 */
+		void wait_in (cudaStream_t stream) const {
+			if (state_.get() == 0 || state_->finished) {
+				return;
+			}
+
+			if (cudaStreamWaitEvent(stream, state_->event, 0) != cudaSuccess) {
+				throw exception::cuda_runtime_error(cudaGetLastError());
+			}
+		}
+
+	public: /***  INTERNAL  ***/
+		/**
+		 * @brief @a keep_alive (e.g. a shared_device_pointer) is kept alive until the operation has finished
+		 */
+		void keep_alive (const boost::any &keep_alive) {
+			state_->keep_alive = keep_alive;
+		}
+
+		/**
+		 * @brief Hands the page-locked @a buffer over to the completion, it is given back to the @c staging_pool when the operation has finished.
+		 */
+		void set_staging_buffer (void* buffer) {
+			state_->staging = buffer;
+		}
+
+		/**
+		 * @brief When the operation has finished, @a size_in_b bytes are copied from the staging buffer to @a destination.
+		 */
+		void set_host_destination (void* destination, const std::size_t size_in_b) {
+			state_->host_destination = destination;
+			state_->host_size = size_in_b;
+		}
+
+	private:
+		/**
+		 * @brief The shared state of all copies of a completion
+		 */
+		struct state {
+			state() : event(0), finished(false), staging(0), host_destination(0), host_size(0) {}
+
+			~state() {
+				try {
+					wait();
+				} catch (...) {
+					// we can not report errors here
+				}
+				if (event != 0) {
+					cudaEventDestroy(event);
+				}
+			}
+
+			void record (cudaStream_t stream) {
+				if (cudaEventCreate(&event) != cudaSuccess || cudaEventRecord(event, stream) != cudaSuccess) {
+					throw exception::cuda_runtime_error(cudaGetLastError());
+				}
+			}
+
+			void wait() {
+				if (finished) {
+					return;
+				}
+				if (cudaEventSynchronize(event) != cudaSuccess) {
+					throw exception::cuda_runtime_error(cudaGetLastError());
+				}
+				finish();
+			}
+
+			void finish() {
+				finished = true;
+
+				if (host_destination != 0) {
+					std::memcpy(host_destination, staging, host_size);
+				}
+				if (staging != 0) {
+					staging_pool::instance().release(staging);
+					staging = 0;
+				}
+				keep_alive = boost::any();
+			}
+
+			cudaEvent_t event;
+			bool finished;
+			void* staging;
+			void* host_destination;
+			std::size_t host_size;
+			boost::any keep_alive;
+
+			private:
+				state (const state&);
+				state& operator= (const state&);
+		};
+
+		/**
+		 * Our state, shared by all copies
+		 */
+		boost::shared_ptr<state> state_;
+};
+
+} // namespace cupp
+
+#endif
@@ -10,6 +10,8 @@
 #error "Not compatible with CUDA. Don't compile with nvcc."
 #endif
 
+#include <cstddef> // Include std::size_t
+#include <ostream>
 #include <string>
 
 // CUDA
@@ -19,6 +21,9 @@
 #include "cupp/exception/no_supporting_device.h"
 #include "cupp/exception/cuda_runtime_error.h"
 #include "cupp/runtime.h"
+#include "cupp/kernel_impl/spill_buffer.h"
+#include "cupp/kernel_impl/write_back_registry.h"
+#include "cupp/kernel_profiler.h"
 
 
 namespace cupp {
@@ -64,6 +69,7 @@ class device {
 	public:
 		/**
 		 * @brief This functions blocks until all requested tasks/kernels have been completed
+		 *        and all values written back lazily (see @c cupp::kernel::set_lazy_write_back()) have arrived on the host
 		 */
 		void sync() const;
 
@@ -72,6 +78,18 @@ class device {
 		 */
 		int id() const;
 
+		/**
+		 * @return The statistics of the global memory CuPP has allocated on @a this device: the bytes in use, the high-water
+		 *         mark, the allocations per size class and per data structure (see @c caching_allocator::statistics)
+		 * @example std::cout << d.memory_stats();
+		 */
+		caching_allocator::statistics memory_stats() const;
+
+		/**
+		 * @brief Writes @c memory_stats() to @a out after every @a interval allocations on any device, passing 0 as @a out stops it
+		 */
+		static void report_memory_stats(std::ostream *out, const std::size_t interval = 1000);
+
 	public: /***  GET INFORMATION ABOUT THE DEVICE  ***/
 		/**
 		 * @return ASCII string identifying this device
@@ -181,6 +199,18 @@ inline device::device (const int major, const int minor) {
 }
 
 inline device::~device() {
+	// the values written back lazily must arrive before their events and staging buffers die
+	try {
+		kernel_impl::write_back_registry::instance().flush_all();
+	} catch (...) {
+		// we can not report errors here
+	}
+
+	// the cached memory blocks, page-locked buffers and events die with the context
+	kernel_impl::spill_buffer::instance().device_reset(id());
+	caching_allocator::instance().device_reset(id());
+	staging_pool::instance().device_reset(id());
+	kernel_profiler::instance().device_reset(id());
 	cudaThreadExit();
 }
 
@@ -249,6 +279,17 @@ inline void device::real_constructor(const int major, const int minor, const cha
 
 inline void device::sync() const {
 	cupp::thread_synchronize();
+
+	// all values written back lazily have arrived now, copy them out of their staging buffers
+	kernel_impl::write_back_registry::instance().flush_all();
+}
+
+inline caching_allocator::statistics device::memory_stats() const {
+	return caching_allocator::instance().stats(id());
+}
+
+inline void device::report_memory_stats(std::ostream *out, const std::size_t interval) {
+	caching_allocator::instance().set_report(out, interval);
 }
 
 inline device::id_t device::id() const {
@@ -264,6 +305,77 @@ inline int device::device_count() {
 	return device_cnt;
 }
 
+/**
+ * @brief Blocks until the new value of @a value has arrived on the host, if it has been passed to a kernel
+ *        with lazy write-back (see @c cupp::kernel::set_lazy_write_back()). Returns immediately otherwise.
+ * @return @a value
+ * @exception cuda_runtime_error
+ */
+template <typename T>
+inline const T& fetch (const T &value) {
+	kernel_impl::write_back_registry::instance().flush (&value);
+	return value;
+}
+
+
+/**
+ * @class write_back_scope
+ * @platform Host only
+ * @brief Lets kernels with lazy write-back (see @c cupp::kernel::set_lazy_write_back()) return the new value of an
+ *        object lazily for the lifetime of the scope. The values of objects without a scope are written back before
+ *        the kernel call returns. When the scope ends, a value still on its way is waited for.
+ * @example result_t r; cupp::write_back_scope scope (r); k (d, r); ...; use (cupp::fetch (r));
+ * @warning Declare the scope after the object, so the scope ends first.
+ */
+class write_back_scope {
+	public:
+		template <typename T>
+		explicit write_back_scope (const T &value) : host_object_(&value) {
+			kernel_impl::write_back_registry::instance().open_scope (host_object_);
+		}
+
+		~write_back_scope() {
+			kernel_impl::write_back_registry::instance().close_scope (host_object_);
+		}
+
+	private:
+		// not copyable
+		write_back_scope (const write_back_scope&);
+		write_back_scope& operator= (const write_back_scope&);
+
+		const void* host_object_;
+};
+
+
+namespace impl {
+
+/**
+ * @class device_guard
+ * @brief Makes @a device_id the current device for its lifetime
+ */
+class device_guard {
+	public:
+		explicit device_guard (const device::id_t device_id) : old_(0) {
+			cudaGetDevice (&old_);
+			if (old_ != device_id) {
+				cudaSetDevice (device_id);
+			}
+		}
+
+		~device_guard() {
+			cudaSetDevice (old_);
+		}
+
+	private:
+		// not copyable
+		device_guard (const device_guard&);
+		device_guard& operator= (const device_guard&);
+
+		device::id_t old_;
+};
+
+} // namespace impl
+
 } // namespace cupp
 
 #endif
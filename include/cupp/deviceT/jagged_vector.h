@@ -0,0 +1,148 @@
+/*
+ * Copyright: See LICENSE file that comes with this distribution
+ *
+ */
+
+#ifndef CUPP_DEVICET_jagged_vector_H
+#define CUPP_DEVICET_jagged_vector_H
+
+#include "cupp/common.h"
+#include "cupp/kernel_type_binding.h"
+#include "cupp/deviceT/vector.h"
+
+namespace cupp {
+
+template <typename T>
+class jagged_vector;
+
+namespace deviceT {
+
+/**
+ * @class jagged_vector
+ * @platform Device only
+ * @brief The device type of @c cupp::jagged_vector. The elements of all rows are stored one after another in
+ *        @a values_, row @a i starts at @a offsets_[i] and ends in front of @a offsets_[i+1].
+ */
+
+template< typename T >
+class jagged_vector {
+	public:
+		/**
+		 * Set up the type bindings
+		 */
+		typedef jagged_vector<T>                                          device_type;
+		typedef cupp::jagged_vector< typename get_type<T>::host_type >    host_type;
+
+		/**
+		 * @typedef size_type
+		 * @brief The type you should use to index this class
+		 */
+		typedef typename vector<T>::size_type size_type;
+
+		/**
+		 * @class row_span
+		 * @brief The elements of one row
+		 */
+		class row_span {
+			public:
+				CUPP_RUN_ON_DEVICE
+				row_span (T* begin, const size_type size) : begin_(begin), size_(size) {}
+
+				CUPP_RUN_ON_DEVICE
+				size_type size() const { return size_; }
+
+				CUPP_RUN_ON_DEVICE
+				T& operator[]( const size_type index ) const { return begin_[index]; }
+
+				CUPP_RUN_ON_DEVICE
+				T* begin() const { return begin_; }
+
+				CUPP_RUN_ON_DEVICE
+				T* end() const { return begin_ + size_; }
+
+			private:
+				T* begin_;
+				size_type size_;
+		};
+
+		/**
+		 * @brief Returns the number of rows
+		 * @platform Host
+		 * @platform Device
+		 */
+		CUPP_RUN_ON_HOST CUPP_RUN_ON_DEVICE
+		size_type size() const;
+
+		/**
+		 * @brief Returns the number of elements in row @a index
+		 * @platform Device
+		 */
+		CUPP_RUN_ON_DEVICE
+		size_type row_size( const size_type index ) const;
+
+		/**
+		 * @brief Access the elements of row @a index
+		 * @platform Device
+		 */
+		CUPP_RUN_ON_DEVICE
+		row_span row( const size_type index );
+
+		/**
+		 * @brief Access all elements, row after row
+		 * @platform Device
+		 */
+		CUPP_RUN_ON_DEVICE
+		vector<T>& values();
+
+		CUPP_RUN_ON_HOST
+		void set_values( const vector<T> &values );
+
+		CUPP_RUN_ON_HOST
+		void set_offsets( const vector<size_type> &offsets );
+
+	/*private:*/
+		/**
+		 * The elements of all rows
+		 */
+		vector<T> values_;
+
+		/**
+		 * The index of the first element of every row in @a values_, followed by the number of elements
+		 */
+		vector<size_type> offsets_;
+};
+
+template <typename T>
+typename jagged_vector<T>::size_type jagged_vector<T>::size() const {
+	return offsets_.size() - 1;
+}
+
+template <typename T>
+typename jagged_vector<T>::size_type jagged_vector<T>::row_size(const size_type index) const {
+	return offsets_[index+1] - offsets_[index];
+}
+
+template <typename T>
+typename jagged_vector<T>::row_span jagged_vector<T>::row(const size_type index) {
+	return row_span (&values_[offsets_[index]], row_size(index));
+}
+
+template <typename T>
+vector<T>& jagged_vector<T>::values() {
+	return values_;
+}
+
+template <typename T>
+void jagged_vector<T>::set_values(const vector<T> &values) {
+	values_ = values;
+}
+
+template <typename T>
+void jagged_vector<T>::set_offsets(const vector<size_type> &offsets) {
+	offsets_ = offsets;
+}
+
+} // namespace deviceT
+} // namespace cupp
+
+#endif
@@ -0,0 +1,160 @@
+/*
+ * Copyright: See LICENSE file that comes with this distribution
+ *
+ */
+
+#ifndef CUPP_DEVICET_soa_vector_H
+#define CUPP_DEVICET_soa_vector_H
+
+#include "cupp/common.h"
+#include "cupp/kernel_type_binding.h"
+
+namespace cupp {
+
+/**
+ * @class soa_fields
+ * @brief The number of fields of @a T stored in their own arrays by @c cupp::soa_vector.
+ *        Defined by @c CUPP_SOA_FIELDS.
+ */
+template <typename T>
+struct soa_fields;
+
+/**
+ * @class soa_field
+ * @brief The type of field @a i of @a T and how to access it. Defined by @c CUPP_SOA_FIELD.
+ */
+template <typename T, int i>
+struct soa_field;
+
+template <typename T>
+class soa_vector;
+
+namespace deviceT {
+
+/**
+ * @class soa_vector
+ * @platform Device only
+ * @brief The device type of @c cupp::soa_vector. Every field is stored in its own array, so threads reading
+ *        the same field of neighbouring elements access neighbouring addresses.
+ * @example float* x = v->field<0>(); x[threadIdx.x] += v->get<1>(threadIdx.x);
+ */
+
+template< typename T >
+class soa_vector {
+	public:
+		/**
+		 * Set up the type bindings
+		 */
+		typedef soa_vector<T>                                      device_type;
+		typedef cupp::soa_vector<T>                                host_type;
+
+		/**
+		 * @typedef size_type
+		 * @brief The type you should use to index this class
+		 */
+		typedef int size_type;
+
+		enum {
+			/**
+			 * The maximum number of fields
+			 */
+			max_fields = 16
+		};
+
+		/**
+		 * @brief Returns the number of elements
+		 * @platform Host
+		 * @platform Device
+		 */
+		CUPP_RUN_ON_HOST CUPP_RUN_ON_DEVICE
+		size_type size() const;
+
+		/**
+		 * @brief Access the array of field @a i
+		 * @platform Device
+		 */
+		template <int i>
+		CUPP_RUN_ON_DEVICE
+		typename soa_field<T, i>::type* field() const {
+			return static_cast<typename soa_field<T, i>::type*>(fields_[i]);
+		}
+
+		/**
+		 * @brief Access field @a i of the element @a index
+		 * @platform Device
+		 */
+		template <int i>
+		CUPP_RUN_ON_DEVICE
+		typename soa_field<T, i>::type& get( const size_type index ) const {
+			return field<i>()[index];
+		}
+
+		CUPP_RUN_ON_HOST
+		void set_field( const int i, void* device_pointer );
+
+		CUPP_RUN_ON_HOST
+		void set_size(const size_type size);
+
+	/*private:*/
+		/**
+		 * The pointers to the arrays of the fields
+		 */
+		void* fields_[max_fields];
+
+		/**
+		 * The number of elements
+		 */
+		size_type size_;
+};
+
+template <typename T>
+typename soa_vector<T>::size_type soa_vector<T>::size() const {
+	return size_;
+}
+
+template <typename T>
+void soa_vector<T>::set_field(const int i, void* device_pointer) {
+	fields_[i] = device_pointer;
+}
+
+template <typename T>
+void soa_vector<T>::set_size(const size_type size) {
+	size_ = size;
+}
+
+} // namespace deviceT
+} // namespace cupp
+
+
+/**
+ * @def CUPP_SOA_FIELDS
+ * @brief Declares that @a n fields of type @a T are stored by @c cupp::soa_vector, each has to be declared with @c CUPP_SOA_FIELD.
+ *        Must be used outside of any namespace.
+ */
+#define CUPP_SOA_FIELDS(T, n) \
+namespace cupp { \
+template <> \
+struct soa_fields< T > { \
+	enum { size = n }; \
+}; \
+}
+
+/**
+ * @def CUPP_SOA_FIELD
+ * @brief Declares the member @a name of type @a field_type as field @a i of type @a T (first field is 0).
+ *        Must be used outside of any namespace.
+ * @example CUPP_SOA_FIELDS(particle, 2) CUPP_SOA_FIELD(particle, 0, float, x) CUPP_SOA_FIELD(particle, 1, float, v)
+ */
+#define CUPP_SOA_FIELD(T, i, field_type, name) \
+namespace cupp { \
+template <> \
+struct soa_field< T, i > { \
+	typedef field_type type; \
+	CUPP_RUN_ON_HOST CUPP_RUN_ON_DEVICE \
+	static type& get (T &that) { return that.name; } \
+	CUPP_RUN_ON_HOST CUPP_RUN_ON_DEVICE \
+	static const type& get (const T &that) { return that.name; } \
+}; \
+}
+
+#endif
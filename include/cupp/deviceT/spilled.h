@@ -0,0 +1,65 @@
+/*
+ * Copyright: See LICENSE file that comes with this distribution
+ *
+ */
+
+#ifndef CUPP_DEVICET_spilled_H
+#define CUPP_DEVICET_spilled_H
+
+#include "cupp/common.h"
+#include "cupp/kernel_type_binding.h"
+
+namespace cupp {
+namespace deviceT {
+
+/**
+ * @class spilled
+ * @platform Device only
+ * @brief A kernel parameter of type T, which is not passed on the cuda function stack but in global memory.
+ *
+ * Use this as the type of a __global__ function parameter, if the parameters of the function do not fit on the
+ * cuda function stack. On the host side you just pass a T to the cupp::kernel, it is copied into a per launch
+ * parameter block in global memory and only a pointer is put on the stack.
+ * @example __global__ void global_function (deviceT::spilled<big_struct> p) { p->member; }
+ */
+template< typename T >
+class spilled {
+	public:
+		/**
+		 * Set up the type bindings
+		 */
+		typedef spilled<T>                           device_type;
+		typedef typename get_type<T>::host_type      host_type;
+
+		/**
+		 * @return The parameter
+		 * @platform Device
+		 */
+		CUPP_RUN_ON_DEVICE
+		T const& get() const { return *device_pointer_; }
+
+		/**
+		 * @return The parameter
+		 * @platform Device
+		 */
+		CUPP_RUN_ON_DEVICE
+		operator T const& () const { return *device_pointer_; }
+
+		/**
+		 * @brief Access the members of the parameter
+		 * @platform Device
+		 */
+		CUPP_RUN_ON_DEVICE
+		T const* operator->() const { return device_pointer_; }
+
+	/*private:*/
+		/**
+		 * The pointer to the parameter in global memory
+		 */
+		T const* device_pointer_;
+};
+
+} // namespace deviceT
+} // namespace cupp
+
+#endif
@@ -14,6 +14,13 @@
 #include "cupp/common.h"
 #include "cupp/runtime.h"
 #include "cupp/shared_device_pointer.h"
+#include "cupp/stream.h"
+#include "cupp/completion.h"
+#include "cupp/kernel_impl/launch_arena.h"
+
+// STD
+#include <cstddef> // Include std::size_t
+#include <vector>
 
 namespace cupp {
 
@@ -33,9 +40,55 @@ class device_reference {
 	public:
 		/**
 		 * Creates a device reference on the device @a dev reflecting to value @a value.
+		 * The value is transfered in the stream of the current kernel call.
+		 */
+		device_reference (const device &dev, const T &value) : dev_(dev), device_value_ptr_ (cupp::malloc<T>(1, "device_reference")), stream_(impl::current_stream()), used_in_(1, stream_) {
+			if (stream_.get() == 0) {
+				cupp::copy_host_to_device (device_value_ptr_, &value);
+			} else {
+				upload_ = cupp::copy_host_to_device_async (device_value_ptr_, &value, 1, stream_);
+			}
+		}
+
+		/**
+		 * Creates a device reference on the device @a dev reflecting to value @a value.
+		 * The memory is taken from @a arena and only valid as long as the launch of the arena.
+		 * The value is transfered together with all other values of @a arena.
+		 */
+		device_reference (const device &dev, const T &value, kernel_impl::launch_arena &arena) : dev_(dev), device_value_ptr_ (arena.allocate(value), false), stream_(arena.get_stream()), used_in_(1, stream_) {
+		}
+
+		/**
+		 * Replaces the value on the device by @a value.
+		 * The value is transfered in the stream of the current kernel call, after the work enqueued before in the
+		 * streams passed to @c use_in(), as a kernel in another stream may still read the old value.
+		 */
+		void set (const T &value) {
+			stream_ = impl::current_stream();
+			if (stream_.get() == 0) {
+				cupp::copy_host_to_device (device_value_ptr_, &value);
+			} else {
+				for (std::size_t i = 0; i < used_in_.size(); ++i) {
+					impl::wait_for_stream (stream_, used_in_[i].get());
+				}
+				upload_ = cupp::copy_host_to_device_async (device_value_ptr_, &value, 1, stream_);
+			}
+			used_in_.assign (1, stream_);
+		}
+
+		/**
+		 * Tells us that work enqueued in @a s reads our value, so @c set() does not overwrite it before that work
+		 * has been done and the @c caching_allocator does not hand out our memory before.
 		 */
-		device_reference (const device &dev, const T &value) : dev_(dev), device_value_ptr_ (cupp::malloc<T>()) {
-			cupp::copy_host_to_device (device_value_ptr_, &value);
+		void use_in (const stream &s) {
+			caching_allocator::instance().use_in_stream (device_value_ptr_.get(), s);
+
+			for (std::size_t i = 0; i < used_in_.size(); ++i) {
+				if (used_in_[i].get() == s.get()) {
+					return;
+				}
+			}
+			used_in_.push_back (s);
 		}
 
 		/**
@@ -43,7 +96,11 @@ class device_reference {
 		 */
 		T get() const {
 			T returnee;
-			cupp::copy_device_to_host (&returnee, device_value_ptr_);
+			if (stream_.get() == 0) {
+				cupp::copy_device_to_host (&returnee, device_value_ptr_);
+			} else {
+				cupp::copy_device_to_host_async (&returnee, device_value_ptr_, 1, stream_).wait();
+			}
 			return returnee;
 		}
 
@@ -61,6 +118,13 @@ class device_reference {
 			return device_value_ptr_;
 		}
 
+		/**
+		 * @return the stream our value is transfered in
+		 */
+		const stream& get_stream() const {
+			return stream_;
+		}
+
 	private:
 		/**
 		 * The device we live on
@@ -72,6 +136,22 @@ class device_reference {
 		 */
 		shared_device_pointer < T > device_value_ptr_;
 
+		/**
+		 * The stream our value is transfered in
+		 */
+		stream stream_;
+
+		/**
+		 * The streams our value has been used in since it has been transfered the last time, including the stream
+		 * of that transfer
+		 */
+		std::vector<stream> used_in_;
+
+		/**
+		 * The pending upload of our value, keeps the staging buffer alive
+		 */
+		completion upload_;
+
 }; // class device_reference
 
 } // namespace cupp
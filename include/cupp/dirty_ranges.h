@@ -0,0 +1,197 @@
+/*
+ * Copyright: See LICENSE file that comes with this distribution
+ *
+ */
+
+#ifndef CUPP_dirty_ranges_H
+#define CUPP_dirty_ranges_H
+
+#if defined(__CUDACC__)
+#error "Not compatible with CUDA. Don't compile with nvcc."
+#endif
+
+// CUPP
+#include "cupp/common.h"
+
+// STD
+#include <algorithm> // Include std::swap
+#include <cstddef> // Include std::size_t
+#include <map>
+
+
+namespace cupp {
+namespace impl {
+
+/**
+ * @class dirty_ranges
+ * @platform Host only
+ * @brief The elements of a data structure which have been changed on the host, stored as coalesced intervals [begin, end).
+ *
+ * Used by @c cupp::vector to transfer only the changed parts of its data to the device. If too many intervals
+ * would be needed, all elements are considered changed.
+ */
+class dirty_ranges {
+	public:
+		typedef std::size_t size_type;
+
+		/**
+		 * @brief The intervals, indexed by their first element, the value is the element behind the last one
+		 */
+		typedef std::map<size_type, size_type> range_map;
+		typedef range_map::const_iterator      const_iterator;
+
+		enum {
+			/**
+			 * The maximum number of intervals stored, if more are needed all elements are considered changed
+			 */
+			max_ranges = 256
+		};
+
+		/**
+		 * @param all true if all elements are considered changed
+		 */
+		explicit dirty_ranges (const bool all = false) : all_(all) {}
+
+		/**
+		 * @brief Marks the element @a index as changed
+		 */
+		void mark (const size_type index) { mark (index, index+1); }
+
+		/**
+		 * @brief Marks the elements [@a begin, @a end) as changed
+		 */
+		void mark (size_type begin, size_type end);
+
+		/**
+		 * @brief Marks all elements changed in @a other as changed
+		 */
+		void mark (const dirty_ranges &other);
+
+		/**
+		 * @brief Marks all elements as changed
+		 */
+		void mark_all() {
+			all_ = true;
+			ranges_.clear();
+		}
+
+		/**
+		 * @brief Marks all elements as unchanged
+		 */
+		void clear() {
+			all_ = false;
+			ranges_.clear();
+		}
+
+		/**
+		 * @brief Exchanges the intervals with @a other
+		 */
+		void swap (dirty_ranges &other) {
+			std::swap (all_, other.all_);
+			ranges_.swap (other.ranges_);
+		}
+
+		/**
+		 * @return true if no element has been changed
+		 */
+		bool empty() const { return !all_ && ranges_.empty(); }
+
+		/**
+		 * @return true if all elements are considered changed
+		 */
+		bool all() const { return all_; }
+
+		/**
+		 * @return true if transfering all of the @a size elements is the better choice,
+		 *         i.e. all elements or more than half of them have been changed
+		 */
+		bool mostly_dirty (const size_type size) const;
+
+		/**
+		 * @return The number of elements in the intervals
+		 */
+		size_type count() const;
+
+		/**
+		 * @brief Access the intervals, only meaningful if @c all() is false
+		 */
+		const_iterator begin() const { return ranges_.begin(); }
+		const_iterator end() const { return ranges_.end(); }
+
+	private:
+		/**
+		 * true means all elements are changed, @a ranges_ is empty then
+		 */
+		bool all_;
+
+		/**
+		 * The changed intervals, they do neither overlap nor touch
+		 */
+		range_map ranges_;
+};
+
+
+inline void dirty_ranges::mark (size_type begin, size_type end) {
+	if (all_ || begin >= end) {
+		return;
+	}
+
+	// the first interval which may touch [begin, end)
+	range_map::iterator it = ranges_.upper_bound(begin);
+	if (it != ranges_.begin()) {
+		range_map::iterator prev = it;
+		--prev;
+		if (prev->second >= begin) {
+			it = prev;
+		}
+	}
+
+	// swallow all intervals touching [begin, end)
+	while (it != ranges_.end() && it->first <= end) {
+		if (it->first < begin) {
+			begin = it->first;
+		}
+		if (it->second > end) {
+			end = it->second;
+		}
+		ranges_.erase(it++);
+	}
+
+	if (ranges_.size() == max_ranges) {
+		mark_all();
+		return;
+	}
+
+	ranges_.insert (std::make_pair(begin, end));
+}
+
+
+inline void dirty_ranges::mark (const dirty_ranges &other) {
+	if (other.all_) {
+		mark_all();
+		return;
+	}
+
+	for (const_iterator it = other.begin(); it != other.end(); ++it) {
+		mark (it->first, it->second);
+	}
+}
+
+
+inline dirty_ranges::size_type dirty_ranges::count() const {
+	size_type returnee = 0;
+	for (const_iterator it = ranges_.begin(); it != ranges_.end(); ++it) {
+		returnee += it->second - it->first;
+	}
+	return returnee;
+}
+
+
+inline bool dirty_ranges::mostly_dirty (const size_type size) const {
+	return all_ || count()*2 > size;
+}
+
+} // namespace impl
+} // namespace cupp
+
+#endif
@@ -0,0 +1,265 @@
+/*
+ * Copyright: See LICENSE file that comes with this distribution
+ *
+ */
+
+#ifndef CUPP_for_each_chunk_H
+#define CUPP_for_each_chunk_H
+
+#if defined(__CUDACC__)
+#error "Not compatible with CUDA. Don't compile with nvcc."
+#endif
+
+// CUPP
+#include "cupp/common.h"
+#include "cupp/device.h"
+#include "cupp/stream.h"
+#include "cupp/vector.h"
+#include "cupp/staging_pool.h"
+#include "cupp/kernel_call_traits.h"
+#include "cupp/tracer.h"
+#include "cupp/exception/cuda_runtime_error.h"
+
+// STD
+#include <cstddef> // Include std::size_t
+#include <cstring> // Include std::memcpy
+#include <algorithm> // Include std::min, std::max
+
+// BOOST
+#include <boost/static_assert.hpp>
+
+// CUDA
+#include <cuda_runtime.h>
+
+
+namespace cupp {
+
+namespace impl {
+
+/**
+ * @return The number of elements of type @a T in one chunk, if the chunk size is not passed to @c for_each_chunk().
+ *         Two chunks are on the device at the same time, so a chunk takes a quarter of the free memory of the device,
+ *         but at most 64 MB, as every chunk is staged in page-locked host memory as well.
+ * @exception cuda_runtime_error
+ */
+template <typename T>
+std::size_t default_chunk_size (const device &d) {
+	static const std::size_t max_chunk_bytes = std::size_t(64) << 20;
+
+	// the free memory of the current device is reported
+	device_guard on_device (d.id());
+
+	std::size_t free_mem = 0;
+	std::size_t total_mem = 0;
+	if (cudaMemGetInfo (&free_mem, &total_mem) != cudaSuccess) {
+		throw exception::cuda_runtime_error(cudaGetLastError());
+	}
+
+	return std::max<std::size_t> (1, std::min (free_mem / 4, max_chunk_bytes) / sizeof(T));
+}
+
+/**
+ * @class chunk_tile
+ * @platform Host only
+ * @brief The device memory one chunk is processed in by @c for_each_chunk().
+ *
+ * A chunk is copied from the host data of the processed vector into a page-locked buffer of the @c staging_pool and
+ * transfered from there straight into the device memory of our vector, the way back goes through the same buffer.
+ * Our vector has no host data at all (see @c vector::resize_device_only()), the buffer is kept for all chunks.
+ */
+template <typename T>
+class chunk_tile {
+	public:
+		typedef typename vector<T>::size_type size_type;
+
+		chunk_tile() : staging_(0), staging_size_(0), destination_(0), count_(0), downloaded_(0) {}
+
+		/**
+		 * @brief Waits for our transfer still running, errors are ignored
+		 */
+		~chunk_tile() {
+			if (downloaded_ != 0) {
+				cudaEventSynchronize (downloaded_);
+				cudaEventDestroy (downloaded_);
+			}
+			try {
+				if (staging_ != 0) {
+					staging_pool::instance().release (staging_);
+				}
+			} catch (...) {
+				// we can not report errors here
+			}
+		}
+
+		/**
+		 * @brief Starts the transfer of the @a count elements at @a source to the device @a d in stream @a s
+		 * @exception cuda_runtime_error
+		 */
+		void upload (const device &d, const stream &s, const T* source, const size_type count) {
+			const std::size_t size_in_b = count * sizeof(T);
+			trace_scope trace ("transfer", "chunk_tile::upload", size_in_b);
+
+			if (staging_size_ < size_in_b) {
+				if (staging_ != 0) {
+					staging_pool::instance().release (staging_);
+					staging_ = 0;
+				}
+				staging_ = staging_pool::instance().acquire (size_in_b);
+				staging_size_ = size_in_b;
+			}
+
+			std::memcpy (staging_, source, size_in_b);
+
+			// our memory on the device is used in the stream of the tile
+			{
+				stream_guard guard (s);
+				vector_.resize_device_only (d, count);
+			}
+
+			if (cudaMemcpyAsync (device_pointer(), staging_, size_in_b, cudaMemcpyHostToDevice, s.get()) != cudaSuccess) {
+				throw exception::cuda_runtime_error(cudaGetLastError());
+			}
+			staging_pool::instance().count_pinned (size_in_b, 0);
+		}
+
+		/**
+		 * @return The vector to pass to the kernel
+		 */
+		vector<T>& get() { return vector_; }
+
+		/**
+		 * @brief Starts the transfer of the chunk changed by the kernel back to @a destination in stream @a s
+		 * @exception cuda_runtime_error
+		 */
+		void download (const stream &s, T* destination) {
+			const std::size_t size_in_b = vector_.device_size_ * sizeof(T);
+			trace_scope trace ("transfer", "chunk_tile::download", size_in_b);
+
+			if (downloaded_ == 0 && cudaEventCreateWithFlags (&downloaded_, cudaEventDisableTiming) != cudaSuccess) {
+				throw exception::cuda_runtime_error(cudaGetLastError());
+			}
+
+			if (cudaMemcpyAsync (staging_, device_pointer(), size_in_b, cudaMemcpyDeviceToHost, s.get()) != cudaSuccess ||
+			    cudaEventRecord (downloaded_, s.get()) != cudaSuccess) {
+				throw exception::cuda_runtime_error(cudaGetLastError());
+			}
+			staging_pool::instance().count_pinned (0, size_in_b);
+
+			destination_ = destination;
+			count_ = vector_.device_size_;
+		}
+
+		/**
+		 * @brief Waits for the transfer started by @c download() and copies the chunk to its destination
+		 * @exception cuda_runtime_error
+		 */
+		void collect() {
+			if (destination_ == 0) {
+				return;
+			}
+
+			if (cudaEventSynchronize (downloaded_) != cudaSuccess) {
+				throw exception::cuda_runtime_error(cudaGetLastError());
+			}
+
+			std::memcpy (destination_, staging_, count_ * sizeof(T));
+			destination_ = 0;
+		}
+
+	private:
+		// not copyable
+		chunk_tile (const chunk_tile&);
+		chunk_tile& operator= (const chunk_tile&);
+
+		T* device_pointer() const {
+			return vector_.memory_ptr_ -> cuda_pointer().get();
+		}
+
+	private:
+		/**
+		 * Only our memory on the device is used
+		 */
+		vector<T> vector_;
+
+		/**
+		 * Our page-locked buffer from the staging_pool
+		 */
+		void* staging_;
+		std::size_t staging_size_;
+
+		/**
+		 * Where the chunk downloaded last goes to, 0 if it has been collected
+		 */
+		T* destination_;
+		size_type count_;
+
+		/**
+		 * Recorded after the last download
+		 */
+		cudaEvent_t downloaded_;
+};
+
+} // namespace impl
+
+
+/**
+ * @brief Calls the element-wise kernel @a k for every chunk of @a chunk_size elements of @a v, so @a v may be bigger
+ *        than the memory of the device @a d.
+ *
+ * The kernel is called with a @c deviceT::vector containing only the elements of one chunk and must not access any
+ * other elements. Two chunks are processed in turns in two streams, so the transfer of the next chunk to the device
+ * overlaps with the kernel working on the current one and the results are transfered back while the next kernel runs.
+ * The chunks are transfered between the host data of @a v and the device through page-locked buffers of the
+ * @c staging_pool, which are reused for all chunks.
+ * The grid of @a k must cover @a chunk_size elements, the last chunk may be smaller (see @c deviceT::vector::size()).
+ * @param chunk_size The number of elements in one chunk, 0 means a quarter of the free memory of @a d (at most 64 MB)
+ * @example kernel k (&scale, dim3(1024), dim3(256)); for_each_chunk (d, k, huge, 1024*256);
+ * @warning The data of @a v on the device is out of date afterwards, it is transfered again by the next kernel using @a v.
+ * @note @a T must be its own device type and copyable with memcpy (see @c is_bitwise_transferable).
+ */
+template <typename kernel_type, typename T>
+void for_each_chunk (const device &d, kernel_type &k, vector<T> &v, typename vector<T>::size_type chunk_size = 0) {
+	BOOST_STATIC_ASSERT(( is_bitwise_transferable<T>::value ));
+
+	typedef typename vector<T>::size_type size_type;
+
+	if (v.empty()) {
+		return;
+	}
+
+	if (chunk_size == 0) {
+		chunk_size = impl::default_chunk_size<T> (d);
+	}
+	chunk_size = std::min (chunk_size, v.size());
+
+	// all chunks are read from and written back to the host data of v
+	typename vector<T>::host_span data (v);
+
+	impl::chunk_tile<T> tiles[2];
+	const stream streams[2] = { stream(d), stream(d) };
+
+	const size_type chunks = (v.size() + chunk_size - 1) / chunk_size;
+
+	for (size_type c = 0; c < chunks; ++c) {
+		const size_type tile = c % 2;
+
+		// the tile still holds the chunk processed two rounds ago, the other tile keeps the device busy meanwhile
+		tiles[tile].collect();
+
+		const size_type begin = c * chunk_size;
+		const size_type end   = std::min (begin + chunk_size, v.size());
+
+		// transfer, kernel and transfer back are enqueued in the stream of the tile
+		tiles[tile].upload (d, streams[tile], data.begin() + begin, end - begin);
+		k (d, streams[tile], tiles[tile].get());
+		tiles[tile].download (streams[tile], data.begin() + begin);
+	}
+
+	// the last two chunks, in the order they have been started
+	tiles[chunks % 2].collect();
+	tiles[(chunks + 1) % 2].collect();
+}
+
+} // namespace cupp
+
+#endif
@@ -0,0 +1,219 @@
+/*
+ * Copyright: See LICENSE file that comes with this distribution
+ *
+ */
+
+#ifndef CUPP_jagged_vector_H
+#define CUPP_jagged_vector_H
+
+#if defined(__CUDACC__)
+#error "Not compatible with CUDA. Don't compile with nvcc."
+#endif
+
+// CUPP
+#include "cupp/common.h"
+#include "cupp/kernel_type_binding.h"
+#include "cupp/kernel_call_traits.h"
+#include "cupp/device.h"
+#include "cupp/device_reference.h"
+#include "cupp/stream.h"
+#include "cupp/vector.h"
+
+#include "cupp/deviceT/jagged_vector.h"
+
+// STD
+#include <vector>
+
+
+namespace cupp {
+
+/**
+ * @class jagged_vector
+ * @platform Host only
+ * @brief A vector of rows of different length, stored in compressed sparse row form:
+ *        the elements of all rows in one @c cupp::vector and the index of the first element of every row in another one.
+ *
+ * Passing a jagged_vector to a kernel transfers both vectors, no matter how many rows there are. Like @c cupp::vector
+ * only the changed elements are transfered, a changed row is only transfered itself. Only the elements can be changed by
+ * a kernel, the number and the length of the rows are fixed on the device.
+ * @example jagged_vector<int> j; j.push_back (row.begin(), row.end()); { jagged_vector<int>::row_span r = j.row(0); r[0] = 1; } k (d, j);
+ */
+template< typename T >
+class jagged_vector {
+	private:
+		typedef typename get_type<T>::device_type                 T_device_type;
+
+	public: /*** TYPEDEFS  ***/
+		typedef deviceT::jagged_vector< T_device_type >           device_type;
+		typedef jagged_vector<T>                                  host_type;
+
+		typedef typename std::vector<T>::size_type                size_type;
+		typedef typename device_type::size_type                   offset_type;
+
+		/**
+		 * Read-write access to the elements of a row, the row is marked as changed when it is destroyed
+		 */
+		typedef typename cupp::vector<T>::host_span               row_span;
+
+		/**
+		 * Read-only access to the elements of a row
+		 */
+		typedef typename cupp::vector<T>::host_view               const_row_span;
+
+	public: /***  CONSTRUCTORS AND DESTRUCTORS  ***/
+		/**
+		 * @brief Creates a jagged_vector without rows
+		 */
+		jagged_vector() : offsets_(1, 0) {}
+
+	public: /***  NORMAL FUNCTIONS  ***/
+		/**
+		 * @return The number of rows
+		 */
+		size_type size() const {
+			return offsets_.size() - 1;
+		}
+
+		/**
+		 * @return true if there is no row
+		 */
+		bool empty() const {
+			return size() == 0;
+		}
+
+		/**
+		 * @return The number of elements in all rows
+		 */
+		size_type total_size() const {
+			return values_.size();
+		}
+
+		/**
+		 * @return The number of elements in row @a index
+		 */
+		size_type row_size( const size_type index ) const {
+			const_offsets offsets (offsets_, index, index+2);
+			return offsets[1] - offsets[0];
+		}
+
+		/**
+		 * @brief Access the elements of row @a index, the row is marked as changed when the span is destroyed
+		 * @warning The span must be destroyed before @a this is passed to a kernel.
+		 */
+		row_span row( const size_type index ) {
+			const_offsets offsets (offsets_, index, index+2);
+			return row_span (values_, offsets[0], offsets[1]);
+		}
+
+		/**
+		 * @brief Read-only access to the elements of row @a index
+		 */
+		const_row_span row( const size_type index ) const {
+			const_offsets offsets (offsets_, index, index+2);
+			return const_row_span (values_, offsets[0], offsets[1]);
+		}
+
+		/**
+		 * @brief Appends a row with the elements [@a start, @a end)
+		 */
+		template <typename input_iterator>
+		void push_back( input_iterator start, input_iterator end ) {
+			values_.insert (values_.end(), start, end);
+			offsets_.push_back (static_cast<offset_type>(values_.size()));
+		}
+
+		/**
+		 * @brief Appends a row with the elements of @a row
+		 */
+		void push_back( const std::vector<T> &row ) {
+			push_back (row.begin(), row.end());
+		}
+
+		/**
+		 * @brief Reserves memory for @a rows rows with @a elements elements in total
+		 */
+		void reserve( const size_type rows, const size_type elements ) {
+			offsets_.reserve (rows+1);
+			values_.reserve (elements);
+		}
+
+		/**
+		 * @brief Removes all rows
+		 */
+		void clear() {
+			values_.clear();
+			offsets_.assign (1, 0);
+		}
+
+		/**
+		 * @brief Access to the elements of all rows, row after row
+		 */
+		cupp::vector<T>& values() {
+			return values_;
+		}
+
+		const cupp::vector<T>& values() const {
+			return values_;
+		}
+
+	public: /*** CuPP kernel call traits implementation ***/
+		/**
+		 * @brief This function is called by the kernel_call_traits
+		 * @return A on the device useable jagged_vector
+		 */
+		device_type transform (const device &d) {
+			// the memory of both vectors is counted for us
+			impl::allocation_tag tag ("jagged_vector");
+
+			// cupp::in() / cupp::out() only apply to our elements, our rows are always needed on the device
+			const access_mode mode = impl::take_access();
+
+			device_type returnee;
+			{
+				impl::access_guard guard (mode);
+				returnee.set_values (values_.transform(d));
+			}
+			{
+				// the kernel never changes our rows
+				impl::access_guard guard (read_only);
+				returnee.set_offsets (offsets_.transform(d));
+			}
+			return returnee;
+		}
+
+		/**
+		 * @brief This function is called by the kernel_call_traits
+		 */
+		void dirty (device_reference< device_type > device_copy) {
+			UNUSED_PARAMETER(device_copy);
+
+			// the kernel can only change our elements, not our rows
+			values_.device_changed();
+			values_.stream_ = impl::current_stream();
+		}
+
+	private:
+		typedef typename cupp::vector<offset_type>::host_view const_offsets;
+
+		/**
+		 * The elements of all rows
+		 */
+		cupp::vector<T> values_;
+
+		/**
+		 * The index of the first element of every row in @a values_, followed by the number of elements
+		 */
+		cupp::vector<offset_type> offsets_;
+};
+
+/**
+ * The elements of a jagged_vector passed by @c cupp::out() are not transfered to the device
+ */
+template <typename T>
+struct uses_access_mode< jagged_vector<T> > {
+	enum { value = true };
+};
+
+} // namespace cupp
+
+#endif
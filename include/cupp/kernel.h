@@ -12,6 +12,7 @@
 
 
 // CUPP
+#include "cupp/access.h"
 #include "cupp/exception/kernel_number_of_parameters_mismatch.h"
 #include "cupp/kernel_impl/kernel_launcher_base.h"
 #include "cupp/kernel_impl/kernel_launcher_impl.h"
@@ -19,6 +20,9 @@
 #include "cupp/kernel_call_traits.h"
 #include "cupp/device.h"
 #include "cupp/device_reference.h"
+#include "cupp/stream.h"
+#include "cupp/kernel_impl/launch_arena.h"
+#include "cupp/kernel_impl/write_back.h"
 
 // STD
 #include <vector>
@@ -56,16 +60,17 @@ class kernel {
 		 * @brief Constructor used to generate a kernel
 		 * @param f A pointer to the kernel function
 		 * @param shared_mem The number of dynamic shared memory needed by this kernel (in bytes)
-		 * @param tokens
+		 * @param stream The stream the kernel is launched in, if no stream is passed to operator()
 		 */
 		template< typename CudaKernelFunc>
-		kernel( CudaKernelFunc f, const size_t shared_mem=0, CUstream_st* tokens = 0) :
+		kernel( CudaKernelFunc f, const size_t shared_mem=0, cudaStream_t stream = 0) :
 		number_of_parameters_ ( boost::function_traits < typename boost::remove_pointer<CudaKernelFunc>::type >::arity ),
-		dirty ( kernel_launcher_impl< CudaKernelFunc >::dirty_parameters() ) {
+		dirty ( kernel_launcher_impl< CudaKernelFunc >::dirty_parameters() ),
+		lazy_write_back_ (false) {
 
 			dim3 grid_dim;
 			dim3 block_dim;
-			kb_ = new kernel_launcher_impl< CudaKernelFunc >(f, grid_dim, block_dim, shared_mem, tokens);
+			kb_ = new kernel_launcher_impl< CudaKernelFunc >(f, grid_dim, block_dim, shared_mem, cupp::stream(stream));
 		}
 		
 		/**
@@ -74,14 +79,15 @@ class kernel {
 		 * @param grid_dim The dimension of the grid, the kernel we be executed on
 		 * @param block_dim The dimension of the block, the kernel we be executed on
 		 * @param shared_mem The number of dynamic shared memory needed by this kernel (in bytes)
-		 * @param tokens
+		 * @param stream The stream the kernel is launched in, if no stream is passed to operator()
 		 */
 		template< typename CudaKernelFunc>
-		kernel( CudaKernelFunc f, const dim3 &grid_dim, const dim3 &block_dim, const size_t shared_mem=0, CUstream_st* tokens = 0) :
+		kernel( CudaKernelFunc f, const dim3 &grid_dim, const dim3 &block_dim, const size_t shared_mem=0, cudaStream_t stream = 0) :
 		number_of_parameters_(boost::function_traits < typename boost::remove_pointer<CudaKernelFunc>::type >::arity),
-		dirty ( kernel_launcher_impl< CudaKernelFunc >::dirty_parameters() ) {
+		dirty ( kernel_launcher_impl< CudaKernelFunc >::dirty_parameters() ),
+		lazy_write_back_ (false) {
 		
-			kb_ = new kernel_launcher_impl< CudaKernelFunc >(f, grid_dim, block_dim, shared_mem, tokens);
+			kb_ = new kernel_launcher_impl< CudaKernelFunc >(f, grid_dim, block_dim, shared_mem, cupp::stream(stream));
 		}
 
 		/**
@@ -119,6 +125,34 @@ class kernel {
 		 * @return The current size of dynamic shared memory
 		 */
 		size_t shared_mem ( ) { return kb_ -> shared_mem(); }
+
+		/**
+		 * @brief Change the stream the kernel is launched in, if no stream is passed to operator()
+		 */
+		void set_stream ( const stream& s ) { kb_ -> set_stream (s); }
+
+		/**
+		 * @return The stream the kernel is launched in, if no stream is passed to operator()
+		 */
+		const stream& get_stream ( ) { return kb_ -> get_stream(); }
+
+		/**
+		 * @brief Enables or disables lazy write-back of the parameters passed by non-const reference.
+		 *
+		 * By default the new values of these parameters are copied back to the host before operator() returns.
+		 * With lazy write-back, the copy of parameters whose host and device type are the same and which define
+		 * no dirty() function is only enqueued in the stream of the call, so operator() does not wait for the kernel.
+		 * The host object is stale until it is passed to the next kernel, @c cupp::fetch() is called for it,
+		 * @c device::sync() is called or its @c cupp::write_back_scope ends.
+		 * Only host objects guarded by a @c cupp::write_back_scope are written back lazily, so a value never arrives
+		 * after its object is gone.
+		 */
+		void set_lazy_write_back ( const bool lazy ) { lazy_write_back_ = lazy; }
+
+		/**
+		 * @return true if lazy write-back is enabled
+		 */
+		bool lazy_write_back ( ) const { return lazy_write_back_; }
 		
 		/**
 		 * @brief Calls the kernel.
@@ -340,6 +374,242 @@ class kernel {
 		void operator()(const device &d, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7, const P8 &p8, const P9 &p9, const P10 &p10, const P11 &p11, const P12 &p12, const P13 &p13, const P14 &p14, const P15 &p15, const P16 &p16 );
 
 
+		/**
+		 * @brief Calls the kernel in the stream @a s.
+		 * @param d The device where you want the kernel to be executed on
+		 * @param s The stream the kernel and the transfers of its parameters are enqueued in
+		 */
+		void operator()(const device &d, const stream &s);
+
+		/**
+		 * @brief Calls the kernel in the stream @a s.
+		 * @param d The device where you want the kernel to be executed on
+		 * @param s The stream the kernel and the transfers of its parameters are enqueued in
+		 * @param p1 The first parameter to be passed to the kernel
+		 */
+		template< typename P1 >
+		void operator()(const device &d, const stream &s, const P1 &p1 );
+
+		/**
+		 * @brief Calls the kernel in the stream @a s.
+		 * @param d The device where you want the kernel to be executed on
+		 * @param s The stream the kernel and the transfers of its parameters are enqueued in
+		 * @param p1 The first parameter to be passed to the kernel
+		 * @param p2 The second parameter to be passed to the kernel
+		 */
+		template< typename P1, typename P2 >
+		void operator()(const device &d, const stream &s, const P1 &p1, const P2 &p2 );
+
+		/**
+		 * @brief Calls the kernel in the stream @a s.
+		 * @param d The device where you want the kernel to be executed on
+		 * @param s The stream the kernel and the transfers of its parameters are enqueued in
+		 * @param p1 The first parameter to be passed to the kernel
+		 * @param p2 The second parameter to be passed to the kernel
+		 * @param p3 The third parameter to be passed to the kernel
+		 */
+		template< typename P1, typename P2, typename P3 >
+		void operator()(const device &d, const stream &s, const P1 &p1, const P2 &p2, const P3 &p3 );
+
+		/**
+		 * @brief Calls the kernel in the stream @a s.
+		 * @param d The device where you want the kernel to be executed on
+		 * @param s The stream the kernel and the transfers of its parameters are enqueued in
+		 * @param p1 The first parameter to be passed to the kernel
+		 * @param p2 The second parameter to be passed to the kernel
+		 * @param p3 The third parameter to be passed to the kernel
+		 * @param p4 ...
+		 */
+		template< typename P1, typename P2, typename P3, typename P4 >
+		void operator()(const device &d, const stream &s, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4 );
+
+		/**
+		 * @brief Calls the kernel in the stream @a s.
+		 * @param d The device where you want the kernel to be executed on
+		 * @param s The stream the kernel and the transfers of its parameters are enqueued in
+		 * @param p1 The first parameter to be passed to the kernel
+		 * @param p2 The second parameter to be passed to the kernel
+		 * @param p3 The third parameter to be passed to the kernel
+		 * @param p4 ...
+		 * @param p5 ...
+		 */
+		template< typename P1, typename P2, typename P3, typename P4, typename P5 >
+		void operator()(const device &d, const stream &s, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5 );
+
+		/**
+		 * @brief Calls the kernel in the stream @a s.
+		 * @param d The device where you want the kernel to be executed on
+		 * @param s The stream the kernel and the transfers of its parameters are enqueued in
+		 * @param p1 The first parameter to be passed to the kernel
+		 * @param p2 The second parameter to be passed to the kernel
+		 * @param p3 The third parameter to be passed to the kernel
+		 * @param p4 ...
+		 * @param p5 ...
+		 * @param p6 ...
+		 */
+		template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6 >
+		void operator()(const device &d, const stream &s, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6 );
+
+		/**
+		 * @brief Calls the kernel in the stream @a s.
+		 * @param d The device where you want the kernel to be executed on
+		 * @param s The stream the kernel and the transfers of its parameters are enqueued in
+		 * @param p1 The first parameter to be passed to the kernel
+		 * @param p2 The second parameter to be passed to the kernel
+		 * @param p3 The third parameter to be passed to the kernel
+		 * @param p4 ...
+		 * @param p5 ...
+		 * @param p6 ...
+		 * @param p7 ...
+		 */
+		template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7 >
+		void operator()(const device &d, const stream &s, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7 );
+
+		/**
+		 * @brief Calls the kernel in the stream @a s.
+		 * @param d The device where you want the kernel to be executed on
+		 * @param s The stream the kernel and the transfers of its parameters are enqueued in
+		 * @param p1 The first parameter to be passed to the kernel
+		 * @param p2 The second parameter to be passed to the kernel
+		 * @param p3 The third parameter to be passed to the kernel
+		 * @param p4 ...
+		 * @param p5 ...
+		 * @param p6 ...
+		 * @param p7 ...
+		 * @param p8 ...
+		 */
+		template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7, typename P8 >
+		void operator()(const device &d, const stream &s, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7, const P8 &p8 );
+
+		/**
+		 * @brief Calls the kernel in the stream @a s.
+		 * @param d The device where you want the kernel to be executed on
+		 * @param s The stream the kernel and the transfers of its parameters are enqueued in
+		 * @param p1 The first parameter to be passed to the kernel
+		 * @param p2 The second parameter to be passed to the kernel
+		 * @param p3 The third parameter to be passed to the kernel
+		 * @param p4 ...
+		 * @param p5 ...
+		 * @param p6 ...
+		 * @param p7 ...
+		 * @param p8 ...
+		 */
+		template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7, typename P8, typename P9 >
+		void operator()(const device &d, const stream &s, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7, const P8 &p8, const P9 &p9 );
+
+		/**
+		 * @brief Calls the kernel in the stream @a s.
+		 * @param d The device where you want the kernel to be executed on
+		 * @param s The stream the kernel and the transfers of its parameters are enqueued in
+		 * @param p1 The first parameter to be passed to the kernel
+		 * @param p2 The second parameter to be passed to the kernel
+		 * @param p3 The third parameter to be passed to the kernel
+		 * @param p4 ...
+		 * @param p5 ...
+		 * @param p6 ...
+		 * @param p7 ...
+		 * @param p8 ...
+		 */
+		template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7, typename P8, typename P9, typename P10 >
+		void operator()(const device &d, const stream &s, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7, const P8 &p8, const P9 &p9, const P10 &p10 );
+
+		/**
+		 * @brief Calls the kernel in the stream @a s.
+		 * @param d The device where you want the kernel to be executed on
+		 * @param s The stream the kernel and the transfers of its parameters are enqueued in
+		 * @param p1 The first parameter to be passed to the kernel
+		 * @param p2 The second parameter to be passed to the kernel
+		 * @param p3 The third parameter to be passed to the kernel
+		 * @param p4 ...
+		 * @param p5 ...
+		 * @param p6 ...
+		 * @param p7 ...
+		 * @param p8 ...
+		 */
+		template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7, typename P8, typename P9, typename P10, typename P11 >
+		void operator()(const device &d, const stream &s, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7, const P8 &p8, const P9 &p9, const P10 &p10, const P11 &p11 );
+
+		/**
+		 * @brief Calls the kernel in the stream @a s.
+		 * @param d The device where you want the kernel to be executed on
+		 * @param s The stream the kernel and the transfers of its parameters are enqueued in
+		 * @param p1 The first parameter to be passed to the kernel
+		 * @param p2 The second parameter to be passed to the kernel
+		 * @param p3 The third parameter to be passed to the kernel
+		 * @param p4 ...
+		 * @param p5 ...
+		 * @param p6 ...
+		 * @param p7 ...
+		 * @param p8 ...
+		 */
+		template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7, typename P8, typename P9, typename P10, typename P11, typename P12 >
+		void operator()(const device &d, const stream &s, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7, const P8 &p8, const P9 &p9, const P10 &p10, const P11 &p11, const P12 &p12 );
+
+		/**
+		 * @brief Calls the kernel in the stream @a s.
+		 * @param d The device where you want the kernel to be executed on
+		 * @param s The stream the kernel and the transfers of its parameters are enqueued in
+		 * @param p1 The first parameter to be passed to the kernel
+		 * @param p2 The second parameter to be passed to the kernel
+		 * @param p3 The third parameter to be passed to the kernel
+		 * @param p4 ...
+		 * @param p5 ...
+		 * @param p6 ...
+		 * @param p7 ...
+		 * @param p8 ...
+		 */
+		template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7, typename P8, typename P9, typename P10, typename P11, typename P12, typename P13 >
+		void operator()(const device &d, const stream &s, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7, const P8 &p8, const P9 &p9, const P10 &p10, const P11 &p11, const P12 &p12, const P13 &p13 );
+
+		/**
+		 * @brief Calls the kernel in the stream @a s.
+		 * @param d The device where you want the kernel to be executed on
+		 * @param s The stream the kernel and the transfers of its parameters are enqueued in
+		 * @param p1 The first parameter to be passed to the kernel
+		 * @param p2 The second parameter to be passed to the kernel
+		 * @param p3 The third parameter to be passed to the kernel
+		 * @param p4 ...
+		 * @param p5 ...
+		 * @param p6 ...
+		 * @param p7 ...
+		 * @param p8 ...
+		 */
+		template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7, typename P8, typename P9, typename P10, typename P11, typename P12, typename P13, typename P14 >
+		void operator()(const device &d, const stream &s, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7, const P8 &p8, const P9 &p9, const P10 &p10, const P11 &p11, const P12 &p12, const P13 &p13, const P14 &p14 );
+
+		/**
+		 * @brief Calls the kernel in the stream @a s.
+		 * @param d The device where you want the kernel to be executed on
+		 * @param s The stream the kernel and the transfers of its parameters are enqueued in
+		 * @param p1 The first parameter to be passed to the kernel
+		 * @param p2 The second parameter to be passed to the kernel
+		 * @param p3 The third parameter to be passed to the kernel
+		 * @param p4 ...
+		 * @param p5 ...
+		 * @param p6 ...
+		 * @param p7 ...
+		 * @param p8 ...
+		 */
+		template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7, typename P8, typename P9, typename P10, typename P11, typename P12, typename P13, typename P14, typename P15 >
+		void operator()(const device &d, const stream &s, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7, const P8 &p8, const P9 &p9, const P10 &p10, const P11 &p11, const P12 &p12, const P13 &p13, const P14 &p14, const P15 &p15 );
+
+		/**
+		 * @brief Calls the kernel in the stream @a s.
+		 * @param d The device where you want the kernel to be executed on
+		 * @param s The stream the kernel and the transfers of its parameters are enqueued in
+		 * @param p1 The first parameter to be passed to the kernel
+		 * @param p2 The second parameter to be passed to the kernel
+		 * @param p3 The third parameter to be passed to the kernel
+		 * @param p4 ...
+		 * @param p5 ...
+		 * @param p6 ...
+		 * @param p7 ...
+		 * @param p8 ...
+		 */
+		template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7, typename P8, typename P9, typename P10, typename P11, typename P12, typename P13, typename P14, typename P15, typename P16 >
+		void operator()(const device &d, const stream &s, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7, const P8 &p8, const P9 &p9, const P10 &p10, const P11 &p11, const P12 &p12, const P13 &p13, const P14 &p14, const P15 &p15, const P16 &p16 );
+
+
 	private:
 		/**
 		 * @brief Calls the dirty kernel_call_traits function if needed
@@ -348,6 +618,23 @@ class kernel {
 		 */
 		template <typename P>
 		inline void handle_call_traits(const P& p, const int i);
+
+		/**
+		 * @brief A parameter passed by @c cupp::in() is never written back
+		 */
+		template <typename P>
+		inline void handle_call_traits(const access_argument<P, read_only>& p, const int i) {
+			UNUSED_PARAMETER(p);
+			UNUSED_PARAMETER(i);
+		}
+
+		/**
+		 * @brief A parameter passed by @c cupp::out() is handled like the parameter itself
+		 */
+		template <typename P>
+		inline void handle_call_traits(const access_argument<P, write_only>& p, const int i) {
+			handle_call_traits (p.get(), i);
+		}
 		
 		/**
 		 * @brief Checks if @a number matches with @a number_of_parameters_
@@ -355,6 +642,22 @@ class kernel {
 		 */
 		inline void check_number_of_parameters (const int number);
 
+		/**
+		 * @brief Launches the kernel in another stream for its lifetime
+		 */
+		class stream_switch {
+			public:
+				stream_switch (kernel_launcher_base &kb, const stream &s) : kb_(kb), old_(kb.get_stream()) {
+					kb_.set_stream(s);
+				}
+				~stream_switch() {
+					kb_.set_stream(old_);
+				}
+			private:
+				kernel_launcher_base &kb_;
+				stream old_;
+		};
+
 	private:
 		/**
 		 * @brief The arity of our function
@@ -375,6 +678,11 @@ class kernel {
 		 * @brief Stores the valuse returned by kb_ -> setup_argument(). They are needed by ther kernel_call_traits.
 		 */
 		std::vector<boost::any> returnee_vec_;
+
+		/**
+		 * @brief true if the parameters passed by non-const reference are written back lazily
+		 */
+		bool lazy_write_back_;
 		
 		template <bool has_device_type, typename P>
 		friend struct local_handle_call_traits;
@@ -398,7 +706,7 @@ struct local_handle_call_traits<true, P> {
 			// we are allowed to make this cast
 			// because this function is only called, when p is passed by reference to the kernel
 			P &temp_p = const_cast<P&>(p);
-			kernel_call_traits<host_type, device_type>::dirty(temp_p, device_ref);
+			write_back<host_type, device_type>(temp_p, device_ref, k->lazy_write_back_);
 		}
 	}
 };
@@ -432,6 +740,8 @@ inline void kernel::operator()(const device &d) {
 template< typename P1 >
 void kernel::operator()(const device &d, const P1 &p1 ) {
 	check_number_of_parameters(1);
+	// transfers of our parameters go into our stream, the per launch objects into one arena
+	kernel_impl::launch_scope scope (kb_ -> get_stream());
 	
 	kb_ -> configure_call();
 
@@ -447,6 +757,8 @@ void kernel::operator()(const device &d, const P1 &p1 ) {
 template< typename P1, typename P2 >
 void kernel::operator()(const device &d, const P1 &p1, const P2 &p2 ) {
 	check_number_of_parameters(2);
+	// transfers of our parameters go into our stream, the per launch objects into one arena
+	kernel_impl::launch_scope scope (kb_ -> get_stream());
 	
 	kb_ -> configure_call();
 
@@ -464,6 +776,8 @@ void kernel::operator()(const device &d, const P1 &p1, const P2 &p2 ) {
 template< typename P1, typename P2, typename P3 >
 void kernel::operator()(const device &d, const P1 &p1, const P2 &p2, const P3 &p3 ) {
 	check_number_of_parameters(3);
+	// transfers of our parameters go into our stream, the per launch objects into one arena
+	kernel_impl::launch_scope scope (kb_ -> get_stream());
 	
 	kb_ -> configure_call();
 
@@ -484,6 +798,8 @@ void kernel::operator()(const device &d, const P1 &p1, const P2 &p2, const P3 &p
 template< typename P1, typename P2, typename P3, typename P4 >
 void kernel::operator()(const device &d, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4 ) {
 	check_number_of_parameters(4);
+	// transfers of our parameters go into our stream, the per launch objects into one arena
+	kernel_impl::launch_scope scope (kb_ -> get_stream());
 	
 	kb_ -> configure_call();
 
@@ -506,6 +822,8 @@ void kernel::operator()(const device &d, const P1 &p1, const P2 &p2, const P3 &p
 template< typename P1, typename P2, typename P3, typename P4, typename P5 >
 void kernel::operator()(const device &d, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5 ) {
 	check_number_of_parameters(5);
+	// transfers of our parameters go into our stream, the per launch objects into one arena
+	kernel_impl::launch_scope scope (kb_ -> get_stream());
 	
 	kb_ -> configure_call();
 
@@ -530,6 +848,8 @@ void kernel::operator()(const device &d, const P1 &p1, const P2 &p2, const P3 &p
 template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6 >
 void kernel::operator()(const device &d, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6 ) {
 	check_number_of_parameters(6);
+	// transfers of our parameters go into our stream, the per launch objects into one arena
+	kernel_impl::launch_scope scope (kb_ -> get_stream());
 	
 	kb_ -> configure_call();
 
@@ -556,6 +876,8 @@ void kernel::operator()(const device &d, const P1 &p1, const P2 &p2, const P3 &p
 template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7 >
 void kernel::operator()(const device &d, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7 ) {
 	check_number_of_parameters(7);
+	// transfers of our parameters go into our stream, the per launch objects into one arena
+	kernel_impl::launch_scope scope (kb_ -> get_stream());
 	
 	kb_ -> configure_call();
 
@@ -584,6 +906,8 @@ void kernel::operator()(const device &d, const P1 &p1, const P2 &p2, const P3 &p
 template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7, typename P8 >
 void kernel::operator()(const device &d, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7, const P8 &p8 ) {
 	check_number_of_parameters(8);
+	// transfers of our parameters go into our stream, the per launch objects into one arena
+	kernel_impl::launch_scope scope (kb_ -> get_stream());
 	
 	kb_ -> configure_call();
 
@@ -614,6 +938,8 @@ void kernel::operator()(const device &d, const P1 &p1, const P2 &p2, const P3 &p
 template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7, typename P8, typename P9 >
 void kernel::operator()(const device &d, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7, const P8 &p8, const P9 &p9 ) {
 	check_number_of_parameters(9);
+	// transfers of our parameters go into our stream, the per launch objects into one arena
+	kernel_impl::launch_scope scope (kb_ -> get_stream());
 	
 	kb_ -> configure_call();
 
@@ -646,6 +972,8 @@ void kernel::operator()(const device &d, const P1 &p1, const P2 &p2, const P3 &p
 template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7, typename P8, typename P9, typename P10 >
 void kernel::operator()(const device &d, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7, const P8 &p8, const P9 &p9, const P10 &p10 ) {
 	check_number_of_parameters(10);
+	// transfers of our parameters go into our stream, the per launch objects into one arena
+	kernel_impl::launch_scope scope (kb_ -> get_stream());
 	
 	kb_ -> configure_call();
 
@@ -680,6 +1008,8 @@ void kernel::operator()(const device &d, const P1 &p1, const P2 &p2, const P3 &p
 template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7, typename P8, typename P9, typename P10, typename P11 >
 void kernel::operator()(const device &d, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7, const P8 &p8, const P9 &p9, const P10 &p10, const P11 &p11 ) {
 	check_number_of_parameters(11);
+	// transfers of our parameters go into our stream, the per launch objects into one arena
+	kernel_impl::launch_scope scope (kb_ -> get_stream());
 	
 	kb_ -> configure_call();
 
@@ -716,6 +1046,8 @@ void kernel::operator()(const device &d, const P1 &p1, const P2 &p2, const P3 &p
 template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7, typename P8, typename P9, typename P10, typename P11, typename P12 >
 void kernel::operator()(const device &d, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7, const P8 &p8, const P9 &p9, const P10 &p10, const P11 &p11, const P12 &p12 ) {
 	check_number_of_parameters(12);
+	// transfers of our parameters go into our stream, the per launch objects into one arena
+	kernel_impl::launch_scope scope (kb_ -> get_stream());
 	
 	kb_ -> configure_call();
 
@@ -754,6 +1086,8 @@ void kernel::operator()(const device &d, const P1 &p1, const P2 &p2, const P3 &p
 template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7, typename P8, typename P9, typename P10, typename P11, typename P12, typename P13 >
 void kernel::operator()(const device &d, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7, const P8 &p8, const P9 &p9, const P10 &p10, const P11 &p11, const P12 &p12, const P13 &p13 ) {
 	check_number_of_parameters(13);
+	// transfers of our parameters go into our stream, the per launch objects into one arena
+	kernel_impl::launch_scope scope (kb_ -> get_stream());
 	
 	kb_ -> configure_call();
 
@@ -794,6 +1128,8 @@ void kernel::operator()(const device &d, const P1 &p1, const P2 &p2, const P3 &p
 template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7, typename P8, typename P9, typename P10, typename P11, typename P12, typename P13, typename P14 >
 void kernel::operator()(const device &d, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7, const P8 &p8, const P9 &p9, const P10 &p10, const P11 &p11, const P12 &p12, const P13 &p13, const P14 &p14 ) {
 	check_number_of_parameters(14);
+	// transfers of our parameters go into our stream, the per launch objects into one arena
+	kernel_impl::launch_scope scope (kb_ -> get_stream());
 	
 	kb_ -> configure_call();
 
@@ -836,6 +1172,8 @@ void kernel::operator()(const device &d, const P1 &p1, const P2 &p2, const P3 &p
 template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7, typename P8, typename P9, typename P10, typename P11, typename P12, typename P13, typename P14, typename P15 >
 void kernel::operator()(const device &d, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7, const P8 &p8, const P9 &p9, const P10 &p10, const P11 &p11, const P12 &p12, const P13 &p13, const P14 &p14, const P15 &p15 ) {
 	check_number_of_parameters(15);
+	// transfers of our parameters go into our stream, the per launch objects into one arena
+	kernel_impl::launch_scope scope (kb_ -> get_stream());
 	
 	kb_ -> configure_call();
 
@@ -880,6 +1218,8 @@ void kernel::operator()(const device &d, const P1 &p1, const P2 &p2, const P3 &p
 template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7, typename P8, typename P9, typename P10, typename P11, typename P12, typename P13, typename P14, typename P15, typename P16 >
 void kernel::operator()(const device &d, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7, const P8 &p8, const P9 &p9, const P10 &p10, const P11 &p11, const P12 &p12, const P13 &p13, const P14 &p14, const P15 &p15, const P16 &p16 ) {
 	check_number_of_parameters(16);
+	// transfers of our parameters go into our stream, the per launch objects into one arena
+	kernel_impl::launch_scope scope (kb_ -> get_stream());
 	
 	kb_ -> configure_call();
 
@@ -922,6 +1262,127 @@ void kernel::operator()(const device &d, const P1 &p1, const P2 &p2, const P3 &p
 	returnee_vec_.clear();
 }
 
+
+
+/***  OPERATPR() WITH STREAM  ***/
+
+inline void kernel::operator()(const device &d, const stream &s) {
+	stream_switch guard (*kb_, s);
+	(*this)(d);
+}
+
+
+template< typename P1 >
+void kernel::operator()(const device &d, const stream &s, const P1 &p1 ) {
+	stream_switch guard (*kb_, s);
+	(*this)(d, p1);
+}
+
+
+template< typename P1, typename P2 >
+void kernel::operator()(const device &d, const stream &s, const P1 &p1, const P2 &p2 ) {
+	stream_switch guard (*kb_, s);
+	(*this)(d, p1, p2);
+}
+
+
+template< typename P1, typename P2, typename P3 >
+void kernel::operator()(const device &d, const stream &s, const P1 &p1, const P2 &p2, const P3 &p3 ) {
+	stream_switch guard (*kb_, s);
+	(*this)(d, p1, p2, p3);
+}
+
+
+template< typename P1, typename P2, typename P3, typename P4 >
+void kernel::operator()(const device &d, const stream &s, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4 ) {
+	stream_switch guard (*kb_, s);
+	(*this)(d, p1, p2, p3, p4);
+}
+
+
+template< typename P1, typename P2, typename P3, typename P4, typename P5 >
+void kernel::operator()(const device &d, const stream &s, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5 ) {
+	stream_switch guard (*kb_, s);
+	(*this)(d, p1, p2, p3, p4, p5);
+}
+
+
+template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6 >
+void kernel::operator()(const device &d, const stream &s, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6 ) {
+	stream_switch guard (*kb_, s);
+	(*this)(d, p1, p2, p3, p4, p5, p6);
+}
+
+
+template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7 >
+void kernel::operator()(const device &d, const stream &s, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7 ) {
+	stream_switch guard (*kb_, s);
+	(*this)(d, p1, p2, p3, p4, p5, p6, p7);
+}
+
+
+template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7, typename P8 >
+void kernel::operator()(const device &d, const stream &s, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7, const P8 &p8 ) {
+	stream_switch guard (*kb_, s);
+	(*this)(d, p1, p2, p3, p4, p5, p6, p7, p8);
+}
+
+
+template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7, typename P8, typename P9 >
+void kernel::operator()(const device &d, const stream &s, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7, const P8 &p8, const P9 &p9 ) {
+	stream_switch guard (*kb_, s);
+	(*this)(d, p1, p2, p3, p4, p5, p6, p7, p8, p9);
+}
+
+
+template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7, typename P8, typename P9, typename P10 >
+void kernel::operator()(const device &d, const stream &s, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7, const P8 &p8, const P9 &p9, const P10 &p10 ) {
+	stream_switch guard (*kb_, s);
+	(*this)(d, p1, p2, p3, p4, p5, p6, p7, p8, p9, p10);
+}
+
+
+template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7, typename P8, typename P9, typename P10, typename P11 >
+void kernel::operator()(const device &d, const stream &s, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7, const P8 &p8, const P9 &p9, const P10 &p10, const P11 &p11 ) {
+	stream_switch guard (*kb_, s);
+	(*this)(d, p1, p2, p3, p4, p5, p6, p7, p8, p9, p10, p11);
+}
+
+
+template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7, typename P8, typename P9, typename P10, typename P11, typename P12 >
+void kernel::operator()(const device &d, const stream &s, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7, const P8 &p8, const P9 &p9, const P10 &p10, const P11 &p11, const P12 &p12 ) {
+	stream_switch guard (*kb_, s);
+	(*this)(d, p1, p2, p3, p4, p5, p6, p7, p8, p9, p10, p11, p12);
+}
+
+
+template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7, typename P8, typename P9, typename P10, typename P11, typename P12, typename P13 >
+void kernel::operator()(const device &d, const stream &s, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7, const P8 &p8, const P9 &p9, const P10 &p10, const P11 &p11, const P12 &p12, const P13 &p13 ) {
+	stream_switch guard (*kb_, s);
+	(*this)(d, p1, p2, p3, p4, p5, p6, p7, p8, p9, p10, p11, p12, p13);
+}
+
+
+template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7, typename P8, typename P9, typename P10, typename P11, typename P12, typename P13, typename P14 >
+void kernel::operator()(const device &d, const stream &s, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7, const P8 &p8, const P9 &p9, const P10 &p10, const P11 &p11, const P12 &p12, const P13 &p13, const P14 &p14 ) {
+	stream_switch guard (*kb_, s);
+	(*this)(d, p1, p2, p3, p4, p5, p6, p7, p8, p9, p10, p11, p12, p13, p14);
+}
+
+
+template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7, typename P8, typename P9, typename P10, typename P11, typename P12, typename P13, typename P14, typename P15 >
+void kernel::operator()(const device &d, const stream &s, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7, const P8 &p8, const P9 &p9, const P10 &p10, const P11 &p11, const P12 &p12, const P13 &p13, const P14 &p14, const P15 &p15 ) {
+	stream_switch guard (*kb_, s);
+	(*this)(d, p1, p2, p3, p4, p5, p6, p7, p8, p9, p10, p11, p12, p13, p14, p15);
+}
+
+
+template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7, typename P8, typename P9, typename P10, typename P11, typename P12, typename P13, typename P14, typename P15, typename P16 >
+void kernel::operator()(const device &d, const stream &s, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7, const P8 &p8, const P9 &p9, const P10 &p10, const P11 &p11, const P12 &p12, const P13 &p13, const P14 &p14, const P15 &p15, const P16 &p16 ) {
+	stream_switch guard (*kb_, s);
+	(*this)(d, p1, p2, p3, p4, p5, p6, p7, p8, p9, p10, p11, p12, p13, p14, p15, p16);
+}
+
 }
 
 #endif
@@ -9,6 +9,7 @@
 #include "cupp/runtime.h"
 #include "cupp/device.h"
 #include "cupp/device_reference.h"
+#include "cupp/kernel_type_binding.h"
 
 #include <iostream>
 
@@ -77,9 +78,9 @@ struct transform_caller {
 		return static_cast<device_type>(that);
 	}
 
-	/// instantiated if 'host_type' is a POD
+	/// instantiated if 'host_type' is a scalar (structs are handled by the overloads above, even if they are PODs)
 	template <typename host_type>
-	static device_type& call( const device &d, host_type& that, typename boost::enable_if< boost::is_POD< host_type > >::type* = 0) {
+	static device_type& call( const device &d, host_type& that, typename boost::enable_if< boost::is_scalar< host_type > >::type* = 0) {
 		UNUSED_PARAMETER(d);
 		return that;
 	}
@@ -144,12 +145,19 @@ struct get_device_ref_caller {
 
 
 				  {
+		// the proxy only lives as long as the kernel call, so its memory is taken from the launch arena
+		if (kernel_impl::current_arena() != 0) {
+			return cupp::device_reference < device_type > (d, transform_caller<device_type>::call(d, that), *kernel_impl::current_arena() );
+		}
 		return cupp::device_reference < device_type > (d, transform_caller<device_type>::call(d, that) );
 	}
 
-	/// instantiated if 'host_type' is a POD
+	/// instantiated if 'host_type' is a scalar (structs are handled by the overloads above, even if they are PODs)
 	template <typename host_type>
-	static device_reference<device_type> call( const device &d, host_type& that, typename boost::enable_if< boost::is_POD< host_type > >::type* = 0) {
+	static device_reference<device_type> call( const device &d, host_type& that, typename boost::enable_if< boost::is_scalar< host_type > >::type* = 0) {
+		if (kernel_impl::current_arena() != 0) {
+			return device_reference<device_type> (d, that, *kernel_impl::current_arena());
+		}
 		return device_reference<device_type> (d, that);
 	}
 };
@@ -210,10 +218,10 @@ struct dirty_caller {
 		that = static_cast<host_type>(device_ref.get());
 	}
 
-	/// instantiated if 'host_type' is a POD
+	/// instantiated if 'host_type' is a scalar (structs are handled by the overloads above, even if they are PODs)
 	template <typename host_type>
 	static void call( host_type& that, device_reference<device_type> device_ref,
-	                  typename boost::enable_if< boost::is_POD< host_type > >::type* = 0) {
+	                  typename boost::enable_if< boost::is_scalar< host_type > >::type* = 0) {
 		that = device_ref.get();
 	}
 };
@@ -266,6 +274,41 @@ struct kernel_call_traits {
 };
 
 
+namespace impl {
+
+/**
+ * @class has_transform
+ * @brief true if @a T is a class defining a transform function returning a @a T
+ */
+template <typename T, bool is_class = boost::is_class<T>::value>
+struct has_transform {
+	enum { value = has_member_transform< T (T::*)(const device&) >::value };
+};
+
+template <typename T>
+struct has_transform<T, false> {
+	enum { value = false };
+};
+
+} // impl
+
+
+/**
+ * @class is_bitwise_transferable
+ * @brief true if an object of type @a T can be copied to and from the device bit by bit, without calling
+ *        @c kernel_call_traits::transform(): the device type is @a T, @a T can be copied with memcpy
+ *        and defines no transform function.
+ * @note Data structures like @c cupp::vector use this to transfer their elements without a temporary copy.
+ *       A specialization of @c kernel_call_traits for such a type is bypassed by them.
+ */
+template <typename T>
+struct is_bitwise_transferable {
+	enum { value = boost::is_same<T, typename get_type<T>::device_type>::value &&
+	               boost::has_trivial_copy<T>::value &&
+	               !impl::has_transform<T>::value };
+};
+
+
 } // cupp
 
 #endif //CUPP_kernel_call_traits_H
@@ -0,0 +1,210 @@
+/*
+ * Copyright: See LICENSE file that comes with this distribution
+ *
+ */
+
+#ifndef CUPP_KERNEL_IMPL_argument_stack_H
+#define CUPP_KERNEL_IMPL_argument_stack_H
+
+// CUPP
+#include "cupp/exception/cuda_runtime_error.h"
+#include "cupp/exception/stack_overflow.h"
+#include "cupp/kernel_impl/launch_arena.h"
+#include "cupp/kernel_profiler.h"
+#include "cupp/tracer.h"
+
+// STD
+#include <cstddef> // Include std::size_t
+#include <cstring> // Include std::memcpy
+#include <cassert>
+
+// BOOST
+#include <boost/type_traits.hpp>
+
+// CUDA
+#include <cuda_runtime.h>
+#include <vector_types.h>
+
+
+// align data correctly
+#define ALIGN_UP(offset, alignment) (offset) = ((offset) + (alignment) - 1) & ~((alignment) - 1)
+
+
+namespace cupp {
+
+namespace deviceT {
+template <typename T>
+class spilled;
+}
+
+namespace kernel_impl {
+
+/**
+ * @class argument_stack
+ * @brief Packs the arguments of one kernel call into a host side buffer, laid out like the cuda function stack.
+ *        The whole buffer is passed to the device together with the launch.
+ *
+ * With CUDA 7.0 or newer the launch is a single call to cudaLaunchKernel, which carries grid, block,
+ * shared memory and stream. Older runtimes get one cudaConfigureCall, one cudaSetupArgument for the whole
+ * buffer and one cudaLaunch, no matter how many arguments are passed.
+ *
+ * Arguments for @c deviceT::spilled parameters are put into the @c launch_arena of the call, only pointers
+ * to them are put on the stack. The arena is uploaded right before the launch.
+ */
+class argument_stack {
+	public:
+		enum {
+			/**
+			 * The size of the cuda function stack. Devices of compute capability 1.x, which are
+			 * only supported by CUDA before 7.0, offer 256 bytes, all others 4 KB.
+			 */
+#if CUDART_VERSION >= 7000
+			max_size = 4096,
+#else
+			max_size = 256,
+#endif
+
+			/**
+			 * The maximum number of arguments, see @c cupp::kernel
+			 */
+			max_arguments = 16
+		};
+
+		argument_stack() : stack_in_use_(0), number_of_arguments_(0) {}
+
+		/**
+		 * @brief Put parameter @a a on the execution stack of the kernel
+		 * @param a The parameter to be copied on the stack
+		 * @exception stack_overflow
+		 */
+		template <typename T>
+		void push (const T &a) {
+			// align the offset based on the current parameter
+			std::size_t offset = stack_in_use_;
+			ALIGN_UP(offset, boost::alignment_of<T>::value);
+
+			if (offset+sizeof(T) > max_size || number_of_arguments_ == max_arguments) {
+				throw exception::stack_overflow();
+			}
+
+			std::memcpy (buffer() + offset, &a, sizeof(T));
+			arguments_[number_of_arguments_++] = buffer() + offset;
+			stack_in_use_ = offset + sizeof(T);
+		}
+
+		/**
+		 * @brief Put parameter @a a in the launch arena in global memory and a pointer to it on the execution stack of the kernel
+		 * @param a The parameter to be copied
+		 * @exception stack_overflow
+		 */
+		template <typename T>
+		void push_spilled (const T &a) {
+			// the launch_scope of the kernel call provides the arena
+			assert (current_arena() != 0 && "Spilled arguments can only be passed inside a launch_scope.");
+
+			const T* device_copy = current_arena()->allocate(a);
+			push (device_copy);
+		}
+
+		/**
+		 * @brief Calls the __global__ function @a func with the arguments pushed so far
+		 * @exception cuda_runtime_error
+		 */
+		void launch (const void* func, const dim3 &grid_dim, const dim3 &block_dim, const std::size_t shared_mem, cudaStream_t stream);
+
+		/**
+		 * @brief Removes all arguments
+		 */
+		void clear() {
+			stack_in_use_ = 0;
+			number_of_arguments_ = 0;
+		}
+
+		/**
+		 * @return How many bytes of the stack are in use
+		 */
+		std::size_t size() const { return stack_in_use_; }
+
+	private:
+		char* buffer() { return static_cast<char*>(buffer_.address()); }
+
+	private:
+		/**
+		 * Our copy of the cuda function stack
+		 */
+		boost::aligned_storage<max_size, 16> buffer_;
+
+		/**
+		 * How many cuda function call stack space is currently in use.
+		 */
+		std::size_t stack_in_use_;
+
+		/**
+		 * Pointers to the arguments inside @a buffer_, as expected by cudaLaunchKernel
+		 */
+		void* arguments_[max_arguments];
+
+		/**
+		 * The number of arguments pushed so far
+		 */
+		int number_of_arguments_;
+};
+
+
+/**
+ * @class argument_pusher
+ * @brief Puts an argument for a parameter of type @a ARG on an @c argument_stack
+ */
+template <typename ARG>
+struct argument_pusher {
+	template <typename T>
+	static void push (argument_stack &stack, const T &a) { stack.push(a); }
+};
+
+template <typename T>
+struct argument_pusher< deviceT::spilled<T> > {
+	template <typename U>
+	static void push (argument_stack &stack, const U &a) { stack.push_spilled(a); }
+};
+
+/**
+ * @brief Puts @a a on @a stack, as expected by a parameter of type @a ARG
+ */
+template <typename ARG, typename T>
+inline void push_argument (argument_stack &stack, const T &a) {
+	argument_pusher< typename boost::remove_cv<ARG>::type >::push(stack, a);
+}
+
+
+inline void argument_stack::launch (const void* func, const dim3 &grid_dim, const dim3 &block_dim, const std::size_t shared_mem, cudaStream_t stream) {
+	// everything the launch needs in global memory is transfered first
+	if (current_arena() != 0) {
+		current_arena()->upload();
+	}
+
+	cupp::impl::trace_scope trace ("kernel", "launch");
+	timed_launch timing (func, grid_dim, block_dim, stream);
+
+#if CUDART_VERSION >= 7000
+	if (cudaLaunchKernel(func, grid_dim, block_dim, arguments_, shared_mem, stream) != cudaSuccess) {
+		throw exception::cuda_runtime_error(cudaGetLastError());
+	}
+#else
+	if (cudaConfigureCall(grid_dim, block_dim, shared_mem, stream) != cudaSuccess) {
+		throw exception::cuda_runtime_error(cudaGetLastError());
+	}
+	if (stack_in_use_ != 0 && cudaSetupArgument(buffer(), stack_in_use_, 0) != cudaSuccess) {
+		throw exception::cuda_runtime_error(cudaGetLastError());
+	}
+	if (cudaLaunch((const char*)func) != cudaSuccess) {
+		throw exception::cuda_runtime_error(cudaGetLastError());
+	}
+#endif
+
+	timing.launched();
+}
+
+} // kernel_impl
+} // cupp
+
+#endif //CUPP_KERNEL_IMPL_argument_stack_H
@@ -8,7 +8,10 @@
 
 #include <boost/any.hpp>
 
-// cuda vector types
+// CUPP
+#include "cupp/stream.h"
+
+// CUDA
 #include <vector_types.h>
 
 namespace cupp {
@@ -69,6 +72,16 @@ class kernel_launcher_base {
 		 * See in @c kernel_launcher_impl.
 		 */
 		virtual size_t shared_mem ( ) = 0;
+
+		/**
+		 * See in @c kernel_launcher_impl.
+		 */
+		virtual void set_stream ( const cupp::stream& ) = 0;
+
+		/**
+		 * See in @c kernel_launcher_impl.
+		 */
+		virtual const cupp::stream& get_stream ( ) = 0;
 		
 		/**
 		 * Virtual destructor
@@ -8,6 +8,7 @@
 
 // CUPP
 #include "cupp/kernel_impl/kernel_launcher_base.h"
+#include "cupp/kernel_impl/argument_stack.h"
 #include "cupp/kernel_impl/is_second_level_const.h"
 #include "cupp/kernel_impl/real_setup_argument.h"
 #include "cupp/kernel_impl/test_dirty.h"
@@ -16,11 +17,14 @@
 #include "cupp/exception/stack_overflow.h"
 #include "cupp/exception/kernel_parameter_type_mismatch.h"
 
+#include "cupp/access.h"
 #include "cupp/kernel_call_traits.h"
 #include "cupp/kernel_type_binding.h"
 #include "cupp/runtime.h"
 #include "cupp/shared_device_pointer.h"
 #include "cupp/device_reference.h"
+#include "cupp/stream.h"
+#include "cupp/kernel_impl/write_back_registry.h"
 
 // CUDA
 #include <vector_types.h>
@@ -34,10 +38,6 @@
 #include <boost/any.hpp>
 
 
-// align data correctly
-#define ALIGN_UP(offset, alignment) (offset) = ((offset) + (alignment) - 1) & ~((alignment) - 1)
-
-
 namespace cupp {
 namespace kernel_impl {
 
@@ -74,14 +74,14 @@ class kernel_launcher_impl : public kernel_launcher_base {
 		 * @param grid_dim The dimension and size of the grid
 		 * @param block_dim The dimension and size of the block
 		 * @param shared_mem The amount of dynamic shared memory needed by the kernel
-		 * @param tokens The number of tokens
+		 * @param stream The stream the kernel is launched in
 		 */
-		kernel_launcher_impl (F func, const dim3 &grid_dim, const dim3 &block_dim, const size_t shared_mem=0, CUstream_st *tokens = 0) :
-		func_(func), grid_dim_(grid_dim), block_dim_(block_dim), shared_mem_(shared_mem), tokens_(tokens), stack_in_use_(0) {};
+		kernel_launcher_impl (F func, const dim3 &grid_dim, const dim3 &block_dim, const size_t shared_mem=0, const cupp::stream &stream = cupp::stream()) :
+		func_(func), grid_dim_(grid_dim), block_dim_(block_dim), shared_mem_(shared_mem), stream_(stream) {};
 
 
 		/**
-		 * Configures the cuda launch. Specifies the grid/block size for the next call.
+		 * Starts a new call. Grid/block size, shared memory and stream are passed to cuda together with the launch.
 		 */
 		virtual void configure_call();
 
@@ -99,7 +99,7 @@ class kernel_launcher_impl : public kernel_launcher_base {
 
 
 		/**
-		 * @brief Calls the __global__ function.
+		 * @brief Calls the __global__ function with all arguments in a single launch.
 		 */
 		virtual void launch();
 
@@ -142,6 +142,16 @@ class kernel_launcher_impl : public kernel_launcher_base {
 		 */
 		virtual size_t shared_mem ( ) { return shared_mem_; }
 
+		/**
+		 * @brief Change the stream the kernel is launched in
+		 */
+		virtual void set_stream ( const cupp::stream& stream ) { stream_ = stream; }
+
+		/**
+		 * @return The stream the kernel is launched in
+		 */
+		virtual const cupp::stream& get_stream ( ) { return stream_; }
+
 	private:
 		/**
 		 * @brief Doing the real work for the public-virtual-non-template version of this function
@@ -155,7 +165,7 @@ class kernel_launcher_impl : public kernel_launcher_base {
 		 * @param a The parameter to be copied on the stack
 		 */
 		template <typename T>
-		void put_argument_on_stack(const T &a);
+		void put_argument_on_stack(const T &a) { stack_.push(a); }
 
 	private:
 		/**
@@ -179,14 +189,14 @@ class kernel_launcher_impl : public kernel_launcher_base {
 		size_t shared_mem_;
 
 		/**
-		 * The tokens ... whatever this may be, cuda docu ist kind of unspecific here
+		 * The stream the kernel is launched in
 		 */
-		CUstream_st* tokens_;
+		cupp::stream stream_;
 		
 		/**
-		 * How many cuda function call stack space is currently in use.
+		 * The arguments of the current call
 		 */
-		size_t stack_in_use_;
+		argument_stack stack_;
 
 		template <int i>
 		friend class real_setup_argument;
@@ -195,18 +205,44 @@ class kernel_launcher_impl : public kernel_launcher_base {
 
 template< typename F_ >
 void kernel_launcher_impl<F_>::configure_call() {
-	if (cudaConfigureCall(grid_dim_, block_dim_, shared_mem_, tokens_) != cudaSuccess) {
-		throw exception::cuda_runtime_error(cudaGetLastError());
-	}
+	stack_.clear();
 }
 
 
 template< typename F_ >
 void kernel_launcher_impl<F_>::launch() {
-	if (cudaLaunch((const char*)func_) != cudaSuccess) {
-		throw exception::cuda_runtime_error(cudaGetLastError());
+	stack_.launch((const void*)func_, grid_dim_, block_dim_, shared_mem_, stream_.get());
+	stack_.clear();
+}
+
+
+/**
+ * @brief Gets the argument out of @a arg, which is passed to cupp::kernel::operator() directly or wrapped by
+ *        @c cupp::in() or @c cupp::out(). @a mode is set to the access mode of the wrapper.
+ * @exception kernel_parameter_type_mismatch
+ */
+template <typename host_type>
+host_type* any_argument_cast (const boost::any &arg, access_mode &mode) {
+	using namespace boost;
+
+	if (const host_type* const* plain = any_cast< const host_type* > (&arg)) {
+		mode = read_write;
+		return const_cast <host_type*> (*plain);
 	}
-	stack_in_use_ = 0;
+
+	if (const access_argument<host_type, read_only>* const* wrapped = any_cast< const access_argument<host_type, read_only>* > (&arg)) {
+		mode = read_only;
+		return const_cast <host_type*> (&(*wrapped)->get());
+	}
+
+	if (const access_argument<host_type, write_only>* const* wrapped = any_cast< const access_argument<host_type, write_only>* > (&arg)) {
+		mode = write_only;
+		return const_cast <host_type*> (&(*wrapped)->get());
+	}
+
+	// ok, something is wrong with the types
+	// let's throw our own exception here
+	throw exception::kernel_parameter_type_mismatch();
 }
 
 
@@ -220,15 +256,14 @@ boost::any kernel_launcher_impl<F_>::setup_argument (const device &d, const boos
 	typedef typename kernel_device_type<host_type>::type device_type;
 
 	//get what is inside our any
-	host_type* temp = 0;
-
-	try {
-		temp = const_cast <host_type*> (any_cast< const host_type* > (arg));
-	} catch (boost::bad_any_cast &) {
-		// ok, something is wrong with the types
-		// let's throw our own exception here
-		throw exception::kernel_parameter_type_mismatch();
-	}
+	access_mode mode = read_write;
+	host_type* temp = any_argument_cast<host_type> (arg, mode);
+
+	// the argument may still wait for its value from an earlier kernel
+	write_back_registry::instance().flush (temp);
+
+	// the data structure may skip transfers, depending on how the kernel uses it
+	impl::access_guard guard (impl::access_guard::for_type<host_type> (mode));
 
 	//if (is_reference <T>()) {
 	if (boost::is_pointer <T>() && has_type_bindings<T>::value ) {
@@ -248,8 +283,8 @@ boost::any kernel_launcher_impl<F_>::setup_argument (const device &d, const boos
 		
 		const device_type device_copy = kernel_call_traits<host_type, device_type>::transform(d, host_copy);
 		
-		// push device_type auf kernel stack
-		put_argument_on_stack(device_copy);
+		// push device_type auf kernel stack (or in the parameter block, if T is spilled)
+		push_argument<T>(stack_, device_copy);
 
 		// return an empty any, this should trigger when some will try to cast it
 		return boost::any();
@@ -257,23 +292,6 @@ boost::any kernel_launcher_impl<F_>::setup_argument (const device &d, const boos
 	}
 }
 
-
-template< typename F_ >
-template <typename T>
-void kernel_launcher_impl<F_>::put_argument_on_stack(const T &a) {
-	if (stack_in_use_+sizeof(T) > 256) {
-		throw exception::stack_overflow();
-	}
-	// align the offset based on the current parameter
-
-	size_t alignof = boost::alignment_of<T>::value;
-	ALIGN_UP(stack_in_use_, alignof);
-	if (cudaSetupArgument(&a, sizeof(T), stack_in_use_) != cudaSuccess) {
-		throw exception::cuda_runtime_error(cudaGetLastError());
-	}
-	stack_in_use_ += sizeof(T);
-}
-
 } // kernel_impl
 } // cupp
 
@@ -0,0 +1,230 @@
+/*
+ * Copyright: See LICENSE file that comes with this distribution
+ *
+ */
+
+#ifndef CUPP_KERNEL_IMPL_launch_arena_H
+#define CUPP_KERNEL_IMPL_launch_arena_H
+
+#if defined(__CUDACC__)
+#error "Not compatible with CUDA. Don't compile with nvcc."
+#endif
+
+// CUPP
+#include "cupp/common.h"
+#include "cupp/stream.h"
+#include "cupp/spill_registry.h"
+#include "cupp/tracer.h"
+#include "cupp/kernel_impl/spill_buffer.h"
+#include "cupp/exception/cuda_runtime_error.h"
+
+// STD
+#include <cstddef> // Include std::size_t
+#include <cstring> // Include std::memcpy
+
+// BOOST
+#include <boost/type_traits.hpp>
+
+// CUDA
+#include <cuda_runtime.h>
+
+
+namespace cupp {
+namespace kernel_impl {
+
+/**
+ * @class launch_arena
+ * @platform Host only
+ * @brief Global memory for the small objects one kernel launch needs on the device, e.g. the values of the
+ *        @c device_reference proxies and the spilled arguments.
+ *
+ * The memory is taken in chunks of @c chunk_size bytes from the @c spill_buffer. The values are collected in a
+ * host side copy of the chunk and copied with a single memcpy, when @c upload() is called right before the launch.
+ * All memory is given back to the @c spill_buffer when the arena is destroyed and the work enqueued in its stream
+ * up to then has been completed.
+ */
+class launch_arena {
+	public:
+		enum {
+			/**
+			 * The size of one chunk, bigger objects get a region of their own
+			 */
+			chunk_size = 4096
+		};
+
+		/**
+		 * @param s The stream of the launch
+		 */
+		explicit launch_arena (const stream &s) : stream_(s), chunk_(0), used_(0), reserved_(false) {}
+
+		/**
+		 * @brief The memory may be reused after the work enqueued in our stream up to now has been completed
+		 */
+		~launch_arena();
+
+		/**
+		 * @brief Copies @a size_in_b bytes from @a value into the arena
+		 * @return The address of the copy on the device, the copy is transfered with the next @c upload()
+		 * @exception cuda_runtime_error
+		 */
+		void* allocate (const void* value, const std::size_t size_in_b, const std::size_t alignment);
+
+		/**
+		 * @brief Copies @a value into the arena
+		 * @return The address of the copy on the device, the copy is transfered with the next @c upload()
+		 * @exception cuda_runtime_error
+		 */
+		template <typename T>
+		T* allocate (const T &value) {
+			return static_cast<T*>(allocate (&value, sizeof(T), boost::alignment_of<T>::value));
+		}
+
+		/**
+		 * @brief Transfers the current chunk to the device. Later allocations are put in a new chunk.
+		 * @exception cuda_runtime_error
+		 */
+		void upload();
+
+		/**
+		 * @return The stream of the launch
+		 */
+		const stream& get_stream() const { return stream_; }
+
+	private:
+		// not copyable
+		launch_arena (const launch_arena&);
+		launch_arena& operator= (const launch_arena&);
+
+		char* host_chunk() { return static_cast<char*>(host_chunk_.address()); }
+
+	private:
+		/**
+		 * The stream all our transfers are enqueued in
+		 */
+		stream stream_;
+
+		/**
+		 * The current chunk in global memory
+		 */
+		char* chunk_;
+
+		/**
+		 * The host side copy of @a chunk_
+		 */
+		boost::aligned_storage<chunk_size, 16> host_chunk_;
+
+		/**
+		 * How many bytes of @a chunk_ are used
+		 */
+		std::size_t used_;
+
+		/**
+		 * true if we got memory from the spill_buffer
+		 */
+		bool reserved_;
+};
+
+
+inline launch_arena::~launch_arena() {
+	if (!reserved_) {
+		return;
+	}
+
+	try {
+		spill_buffer::instance().retire (stream_.get());
+	} catch (...) {
+		// we can not report errors here
+	}
+}
+
+
+inline void* launch_arena::allocate (const void* value, const std::size_t size_in_b, const std::size_t alignment) {
+	if (size_in_b > chunk_size) {
+		// too big for a chunk, so it gets its own region
+		void* returnee = spill_buffer::instance().reserve (size_in_b);
+		reserved_ = true;
+
+		cupp::impl::trace_scope trace ("transfer", "launch_arena::upload", size_in_b);
+
+		// a copy from pageable memory returns when the source has been read
+		if (cudaMemcpyAsync (returnee, value, size_in_b, cudaMemcpyHostToDevice, stream_.get()) != cudaSuccess) {
+			throw exception::cuda_runtime_error(cudaGetLastError());
+		}
+		return returnee;
+	}
+
+	std::size_t offset = (used_ + alignment - 1) & ~(alignment - 1);
+
+	if (chunk_ == 0 || offset + size_in_b > chunk_size) {
+		upload();
+
+		chunk_ = static_cast<char*>(spill_buffer::instance().reserve (chunk_size));
+		reserved_ = true;
+		offset = 0;
+	}
+
+	std::memcpy (host_chunk() + offset, value, size_in_b);
+	used_ = offset + size_in_b;
+
+	return chunk_ + offset;
+}
+
+
+inline void launch_arena::upload() {
+	if (chunk_ == 0) {
+		return;
+	}
+
+	cupp::impl::trace_scope trace ("transfer", "launch_arena::upload", used_);
+
+	// a copy from pageable memory returns when the source has been read, so the host chunk can be reused afterwards
+	if (cudaMemcpyAsync (chunk_, host_chunk(), used_, cudaMemcpyHostToDevice, stream_.get()) != cudaSuccess) {
+		throw exception::cuda_runtime_error(cudaGetLastError());
+	}
+
+	// the rest of the chunk is given back, the next allocation starts a new chunk
+	spill_buffer::instance().shrink (chunk_, used_);
+	chunk_ = 0;
+	used_ = 0;
+}
+
+
+/**
+ * @return The arena of the kernel launch currently set up, 0 if there is none
+ */
+inline launch_arena*& current_arena() {
+	static launch_arena* current = 0;
+	return current;
+}
+
+
+/**
+ * @class launch_scope
+ * @brief Used by the kernel calls. For its lifetime the transfers of the parameters go into the stream @a s
+ *        (see @c cupp::impl::current_stream()) and the per launch objects into a @c launch_arena (see @c current_arena()).
+ *        The parameters used by the call are not spilled (see @c spill_registry), their transfers are traced as
+ *        triggered by a "kernel argument" (see @c tracer).
+ */
+class launch_scope {
+	public:
+		explicit launch_scope (const stream &s) : trigger_("kernel argument"), current_stream_(s), arena_(s), old_arena_(current_arena()) {
+			current_arena() = &arena_;
+			spill_registry::instance().begin_launch();
+		}
+
+		~launch_scope() {
+			spill_registry::instance().end_launch();
+			current_arena() = old_arena_;
+		}
+
+	private:
+		cupp::impl::trace_trigger trigger_;
+		cupp::impl::stream_guard current_stream_;
+		launch_arena arena_;
+		launch_arena* old_arena_;
+};
+
+} // kernel_impl
+} // cupp
+
+#endif //CUPP_KERNEL_IMPL_launch_arena_H
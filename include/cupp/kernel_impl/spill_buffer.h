@@ -0,0 +1,424 @@
+/*
+ * Copyright: See LICENSE file that comes with this distribution
+ *
+ */
+
+#ifndef CUPP_KERNEL_IMPL_spill_buffer_H
+#define CUPP_KERNEL_IMPL_spill_buffer_H
+
+#if defined(__CUDACC__)
+#error "Not compatible with CUDA. Don't compile with nvcc."
+#endif
+
+// CUPP
+#include "cupp/common.h"
+#include "cupp/runtime.h"
+#include "cupp/exception/cuda_runtime_error.h"
+
+// STD
+#include <cstddef> // Include std::size_t
+#include <deque>
+#include <map>
+#include <utility> // Include std::pair, std::make_pair
+#include <vector>
+
+// CUDA
+#include <cuda_runtime.h>
+
+
+namespace cupp {
+namespace kernel_impl {
+
+/**
+ * @class spill_buffer
+ * @platform Host only
+ * @brief A ring buffer in global memory, one per device, holding data needed by kernel launches that does not fit
+ *        on the cuda function stack.
+ *
+ * A launch reserves its regions with @c reserve() and hands them back with @c retire() right after the launch.
+ * @c retire() records an event in the stream of the launch, a region is only reused after this event has
+ * completed. The events are taken from a pool of the ring and given back, when the last region of their launch
+ * is reused. So in the common case a launch costs no allocation at all. Requests which do not fit into
+ * the ring are served by an allocation of their own, which is freed the same way.
+ *
+ * @warning This class is not thread safe, just like the rest of CuPP.
+ */
+class spill_buffer {
+	public:
+		typedef int id_t;
+
+		/**
+		 * @brief Alignment of every region in bytes
+		 */
+		static const std::size_t alignment = 256;
+
+	public: /***  CONSTRUCTORS & DESTRUCTORS  ***/
+		/**
+		 * @return The one and only spill buffer
+		 */
+		static spill_buffer& instance() {
+			static spill_buffer buffer;
+			return buffer;
+		}
+
+	public:
+		/**
+		 * @brief Sets the size of the ring of each device in bytes, used when a ring is created the next time
+		 */
+		void set_ring_size (const std::size_t ring_size) { ring_size_ = ring_size; }
+
+		/**
+		 * @return The size of the ring of each device in bytes
+		 */
+		std::size_t ring_size () const { return ring_size_; }
+
+		/**
+		 * @return @a size_in_b bytes of global memory on the current device, valid until the work enqueued
+		 *         after the next call to @c retire() has been completed
+		 * @exception cuda_runtime_error
+		 */
+		void* reserve (const std::size_t size_in_b);
+
+		/**
+		 * @brief Gives the end of @a region back, only @a size_in_b bytes of it are still needed.
+		 *        Nothing happens, if @a region is not the last region reserved.
+		 */
+		void shrink (void* region, const std::size_t size_in_b);
+
+		/**
+		 * @brief All regions reserved since the last call are reused, after the work enqueued in @a stream so far has been completed.
+		 * @exception cuda_runtime_error
+		 */
+		void retire (cudaStream_t stream);
+
+		/**
+		 * @brief Waits for all launches using the ring of the current device and frees it
+		 * @exception cuda_runtime_error
+		 */
+		void release ();
+
+		/**
+		 * @brief Frees the ring of @a device_id, called before the device is reset
+		 */
+		void device_reset (const id_t device_id);
+
+	private:
+		spill_buffer() : ring_size_(std::size_t(1) << 20) {}
+
+		// not copyable
+		spill_buffer (const spill_buffer&);
+		spill_buffer& operator= (const spill_buffer&);
+
+		/**
+		 * @brief A reserved part of the ring or an allocation of its own
+		 */
+		struct region {
+			region() : begin(0), end(0), memory(0), event(0) {}
+
+			std::size_t begin;
+			std::size_t end;
+
+			/**
+			 * Only set if the region is not part of the ring
+			 */
+			void* memory;
+
+			/**
+			 * Shared by all regions of one launch, 0 until the region has been retired
+			 */
+			cudaEvent_t event;
+		};
+
+		/**
+		 * @brief The ring of one device
+		 */
+		struct ring {
+			ring() : memory(0), size(0), head(0) {}
+
+			char* memory;
+			std::size_t size;
+
+			/**
+			 * The next free byte
+			 */
+			std::size_t head;
+
+			/**
+			 * The regions still in use, the oldest one first
+			 */
+			std::deque<region> in_flight;
+
+			/**
+			 * The allocations not part of the ring still in use
+			 */
+			std::vector<region> dedicated;
+
+			/**
+			 * The events of retired launches and how many regions still use them
+			 */
+			std::vector< std::pair<cudaEvent_t, std::size_t> > events_in_use;
+
+			/**
+			 * Events not in use, created on the device of the ring
+			 */
+			std::vector<cudaEvent_t> free_events;
+		};
+
+		static id_t current_device () {
+			id_t cur_device = 0;
+			cudaGetDevice(&cur_device);
+			return cur_device;
+		}
+
+		/**
+		 * @brief Waits for the event of @a r, if it has already been retired
+		 * @return false if @a r has not been retired
+		 */
+		static bool wait (const region &r);
+
+		/**
+		 * @brief Waits until @a size bytes starting at the head of @a the_ring are no longer used, the head may wrap around
+		 * @return false if the space is used by regions not retired yet
+		 */
+		static bool make_room (ring &the_ring, const std::size_t size);
+
+		/**
+		 * @brief Frees all dedicated allocations of @a the_ring which are no longer used
+		 */
+		static void collect_dedicated (ring &the_ring, const bool block);
+
+		/**
+		 * @brief Forgets about the region @a r of @a the_ring, its event is put back into the pool if no other
+		 *        region uses it
+		 */
+		static void drop (ring &the_ring, const region &r);
+
+		/**
+		 * @brief Destroys all events of @a the_ring
+		 */
+		static void destroy_events (ring &the_ring);
+
+	private:
+		/**
+		 * The size of newly created rings
+		 */
+		std::size_t ring_size_;
+
+		/**
+		 * Our rings, one per device
+		 */
+		std::map<id_t, ring> rings_;
+};
+
+
+inline bool spill_buffer::wait (const region &r) {
+	if (r.event == 0) {
+		return false;
+	}
+	if (cudaEventSynchronize(r.event) != cudaSuccess) {
+		throw exception::cuda_runtime_error(cudaGetLastError());
+	}
+	return true;
+}
+
+
+inline void spill_buffer::collect_dedicated (ring &the_ring, const bool block) {
+	for (std::size_t i = 0; i < the_ring.dedicated.size(); ) {
+		region &r = the_ring.dedicated[i];
+
+		const bool done = r.event != 0 && (block ? wait(r) : cudaEventQuery(r.event) == cudaSuccess);
+		if (!done) {
+			++i;
+			continue;
+		}
+
+		cupp::free(r.memory);
+		drop (the_ring, r);
+		r = the_ring.dedicated.back();
+		the_ring.dedicated.pop_back();
+	}
+}
+
+
+inline void* spill_buffer::reserve (const std::size_t size_in_b) {
+	ring &the_ring = rings_[current_device()];
+
+	collect_dedicated (the_ring, false);
+
+	if (the_ring.memory == 0) {
+		the_ring.memory = cupp::malloc<char>(ring_size_, "spill_buffer");
+		the_ring.size = ring_size_;
+	}
+
+	const std::size_t size = (size_in_b + alignment - 1) & ~(alignment - 1);
+
+	if (size <= the_ring.size && make_room (the_ring, size)) {
+		region r;
+		r.begin = the_ring.head;
+		r.end   = the_ring.head + size;
+		the_ring.in_flight.push_back(r);
+		the_ring.head = r.end;
+
+		return the_ring.memory + r.begin;
+	}
+
+	// the ring is too small
+	region r;
+	r.memory = cupp::malloc<char>(size, "spill_buffer");
+	the_ring.dedicated.push_back(r);
+
+	return r.memory;
+}
+
+
+inline bool spill_buffer::make_room (ring &the_ring, const std::size_t size) {
+	std::deque<region> &in_flight = the_ring.in_flight;
+
+	if (the_ring.head + size > the_ring.size) {
+		// does not fit at the end, so we wrap around
+		// the regions at the end are the oldest ones, they must be finished first
+		while (!in_flight.empty() && in_flight.front().begin >= the_ring.head) {
+			if (!wait(in_flight.front())) {
+				return false;
+			}
+			drop (the_ring, in_flight.front());
+			in_flight.pop_front();
+		}
+		the_ring.head = 0;
+	}
+
+	// wait until the oldest regions in our way are no longer used
+	while (!in_flight.empty() && in_flight.front().end > the_ring.head && in_flight.front().begin < the_ring.head + size) {
+		if (!wait(in_flight.front())) {
+			// in use by the launch currently set up
+			return false;
+		}
+		drop (the_ring, in_flight.front());
+		in_flight.pop_front();
+	}
+
+	return true;
+}
+
+
+inline void spill_buffer::shrink (void* region, const std::size_t size_in_b) {
+	ring &the_ring = rings_[current_device()];
+
+	if (the_ring.in_flight.empty()) {
+		return;
+	}
+
+	struct region &last = the_ring.in_flight.back();
+	if (last.event != 0 || the_ring.memory + last.begin != region) {
+		return;
+	}
+
+	last.end = last.begin + ((size_in_b + alignment - 1) & ~(alignment - 1));
+	the_ring.head = last.end;
+}
+
+
+inline void spill_buffer::drop (ring &the_ring, const region &r) {
+	std::vector< std::pair<cudaEvent_t, std::size_t> > &in_use = the_ring.events_in_use;
+
+	for (std::size_t i = 0; i < in_use.size(); ++i) {
+		if (in_use[i].first != r.event) {
+			continue;
+		}
+		if (--in_use[i].second == 0) {
+			the_ring.free_events.push_back (in_use[i].first);
+			in_use[i] = in_use.back();
+			in_use.pop_back();
+		}
+		return;
+	}
+}
+
+
+inline void spill_buffer::destroy_events (ring &the_ring) {
+	for (std::size_t i = 0; i < the_ring.events_in_use.size(); ++i) {
+		cudaEventDestroy (the_ring.events_in_use[i].first);
+	}
+	for (std::size_t i = 0; i < the_ring.free_events.size(); ++i) {
+		cudaEventDestroy (the_ring.free_events[i]);
+	}
+	the_ring.events_in_use.clear();
+	the_ring.free_events.clear();
+}
+
+
+inline void spill_buffer::retire (cudaStream_t stream) {
+	ring &the_ring = rings_[current_device()];
+
+	cudaEvent_t event = 0;
+	if (!the_ring.free_events.empty()) {
+		event = the_ring.free_events.back();
+		the_ring.free_events.pop_back();
+	} else if (cudaEventCreateWithFlags(&event, cudaEventDisableTiming) != cudaSuccess) {
+		throw exception::cuda_runtime_error(cudaGetLastError());
+	}
+
+	if (cudaEventRecord(event, stream) != cudaSuccess) {
+		the_ring.free_events.push_back (event);
+		throw exception::cuda_runtime_error(cudaGetLastError());
+	}
+
+	std::size_t users = 0;
+	for (std::deque<region>::reverse_iterator it = the_ring.in_flight.rbegin(); it != the_ring.in_flight.rend() && it->event == 0; ++it) {
+		it->event = event;
+		++users;
+	}
+	for (std::size_t i = 0; i < the_ring.dedicated.size(); ++i) {
+		if (the_ring.dedicated[i].event == 0) {
+			the_ring.dedicated[i].event = event;
+			++users;
+		}
+	}
+
+	if (users == 0) {
+		the_ring.free_events.push_back (event);
+	} else {
+		the_ring.events_in_use.push_back (std::make_pair (event, users));
+	}
+}
+
+
+inline void spill_buffer::release () {
+	const id_t dev = current_device();
+	ring &the_ring = rings_[dev];
+
+	while (!the_ring.in_flight.empty()) {
+		wait (the_ring.in_flight.front());
+		drop (the_ring, the_ring.in_flight.front());
+		the_ring.in_flight.pop_front();
+	}
+	collect_dedicated (the_ring, true);
+
+	cupp::free (the_ring.memory);
+	destroy_events (the_ring);
+	rings_.erase(dev);
+}
+
+
+inline void spill_buffer::device_reset (const id_t device_id) {
+	std::map<id_t, ring>::iterator it = rings_.find(device_id);
+	if (it == rings_.end()) {
+		return;
+	}
+
+	// the memory dies with the context anyway, so errors are of no interest here
+	try {
+		cupp::free (it->second.memory);
+		for (std::size_t i = 0; i < it->second.dedicated.size(); ++i) {
+			cupp::free (it->second.dedicated[i].memory);
+		}
+	} catch (...) {}
+	destroy_events (it->second);
+
+	rings_.erase(it);
+}
+
+} // kernel_impl
+} // cupp
+
+#endif //CUPP_KERNEL_IMPL_spill_buffer_H
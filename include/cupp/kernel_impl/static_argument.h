@@ -0,0 +1,180 @@
+/*
+ * Copyright: See LICENSE file that comes with this distribution
+ *
+ */
+
+#ifndef CUPP_KERNEL_IMPL_static_argument_H
+#define CUPP_KERNEL_IMPL_static_argument_H
+
+// CUPP
+#include "cupp/common.h"
+#include "cupp/access.h"
+#include "cupp/kernel_impl/is_second_level_const.h"
+#include "cupp/kernel_impl/argument_stack.h"
+#include "cupp/kernel_call_traits.h"
+#include "cupp/kernel_type_binding.h"
+#include "cupp/device_reference.h"
+#include "cupp/kernel_impl/write_back.h"
+#include "cupp/kernel_impl/write_back_registry.h"
+
+// BOOST
+#include <boost/type_traits.hpp>
+#include <boost/static_assert.hpp>
+
+
+namespace cupp {
+namespace kernel_impl {
+
+/**
+ * @class parameter_type
+ * @brief The type of parameter @a pos of the __global__ function @a F (first position is 1, we follow the boost naming here)
+ */
+template <typename F, int pos>
+struct parameter_type;
+
+#define CUPP_PARAMETER_TYPE(a) \
+template <typename F> \
+struct parameter_type<F, a> { \
+	typedef typename boost::function_traits<F>::arg##a##_type type; \
+};
+
+CUPP_PARAMETER_TYPE(1)
+CUPP_PARAMETER_TYPE(2)
+CUPP_PARAMETER_TYPE(3)
+CUPP_PARAMETER_TYPE(4)
+CUPP_PARAMETER_TYPE(5)
+CUPP_PARAMETER_TYPE(6)
+CUPP_PARAMETER_TYPE(7)
+CUPP_PARAMETER_TYPE(8)
+CUPP_PARAMETER_TYPE(9)
+CUPP_PARAMETER_TYPE(10)
+CUPP_PARAMETER_TYPE(11)
+CUPP_PARAMETER_TYPE(12)
+CUPP_PARAMETER_TYPE(13)
+CUPP_PARAMETER_TYPE(14)
+CUPP_PARAMETER_TYPE(15)
+CUPP_PARAMETER_TYPE(16)
+
+#undef CUPP_PARAMETER_TYPE
+
+
+/**
+ * @class no_holder
+ * @brief What @c static_argument keeps for a parameter passed by value: nothing
+ */
+struct no_holder {};
+
+
+/**
+ * @class static_argument
+ * @brief The compile time version of kernel_launcher_impl::setup_argument() and kernel::handle_call_traits(). Used by @c cupp::typed_kernel.
+ * @param ARG The type of the parameter of the __global__ function
+ * @param P The type of the argument passed to @c cupp::typed_kernel::operator()
+ * @param by_reference true if the __global__ function expects a reference
+ */
+template <typename ARG, typename P, bool by_reference = boost::is_pointer<ARG>::value && has_type_bindings<ARG>::value >
+struct static_argument;
+
+
+/**
+ * A parameter passed by value: the argument is transformed and pushed on the stack
+ */
+template <typename ARG, typename P>
+struct static_argument<ARG, P, false> {
+	typedef typename kernel_host_type<ARG>::type host_type;
+	typedef typename kernel_device_type<host_type>::type device_type;
+
+	typedef no_holder holder;
+
+	// If you come here with a compiler error, you passed an argument to cupp::typed_kernel
+	// which does not match the type expected by the __global__ function.
+	BOOST_STATIC_ASSERT(( boost::is_same<typename boost::remove_cv<P>::type, host_type>::value ));
+
+	static holder setup (const device &d, const P &p, argument_stack &stack) {
+		// p may still wait for its value from an earlier kernel
+		write_back_registry::instance().flush (&p);
+
+		//invoke the copy constructor ...
+		host_type host_copy (p);
+
+		push_argument<ARG> (stack, kernel_call_traits<host_type, device_type>::transform(d, host_copy));
+
+		return holder();
+	}
+
+	static void finish (const P &p, const holder &h, const bool lazy) {
+		UNUSED_PARAMETER(p);
+		UNUSED_PARAMETER(h);
+		UNUSED_PARAMETER(lazy);
+	}
+};
+
+
+/**
+ * A parameter passed by reference: a device reference is pushed on the stack and kept until the kernel is done
+ */
+template <typename ARG, typename P>
+struct static_argument<ARG, P, true> {
+	typedef typename kernel_host_type<ARG>::type host_type;
+	typedef typename kernel_device_type<host_type>::type device_type;
+
+	typedef device_reference<device_type> holder;
+
+	// If you come here with a compiler error, you passed an argument to cupp::typed_kernel
+	// which does not match the type expected by the __global__ function.
+	BOOST_STATIC_ASSERT(( boost::is_same<typename boost::remove_cv<P>::type, host_type>::value ));
+
+	static holder setup (const device &d, const P &p, argument_stack &stack) {
+		// p may still wait for its value from an earlier kernel
+		write_back_registry::instance().flush (&p);
+
+		holder device_ref ( kernel_call_traits<host_type, device_type>::get_device_reference (d, const_cast<host_type&>(p)) );
+
+		// push address of device_copy in global memory of type device_type* on kernel_stack
+		stack.push (device_ref.get_device_ptr().get());
+
+		return device_ref;
+	}
+
+	static void finish (const P &p, const holder &h, const bool lazy) {
+		if (boost::is_pointer<ARG>::value && !is_second_level_const<ARG>::value) {
+			// we are allowed to make this cast
+			// because p is passed by non-const reference to the kernel
+			write_back (const_cast<host_type&>(p), h, lazy);
+		}
+	}
+};
+
+
+/**
+ * An argument wrapped by @c cupp::in() or @c cupp::out(): handled like the argument itself,
+ * but the data structure is told how the kernel accesses it
+ */
+template <typename ARG, typename T, access_mode mode>
+struct access_static_argument {
+	typedef static_argument<ARG, T> real_argument;
+	typedef typename real_argument::holder holder;
+
+	static holder setup (const device &d, const access_argument<T, mode> &p, argument_stack &stack) {
+		impl::access_guard guard (impl::access_guard::for_type<T> (mode));
+		return real_argument::setup (d, p.get(), stack);
+	}
+
+	static void finish (const access_argument<T, mode> &p, const holder &h, const bool lazy) {
+		// an argument only read by the kernel has not been changed
+		if (mode != read_only) {
+			real_argument::finish (p.get(), h, lazy);
+		}
+	}
+};
+
+template <typename ARG, typename T, access_mode mode>
+struct static_argument<ARG, access_argument<T, mode>, false> : public access_static_argument<ARG, T, mode> {};
+
+template <typename ARG, typename T, access_mode mode>
+struct static_argument<ARG, access_argument<T, mode>, true> : public access_static_argument<ARG, T, mode> {};
+
+} // kernel_impl
+} // cupp
+
+#endif //CUPP_KERNEL_IMPL_static_argument_H
@@ -0,0 +1,83 @@
+/*
+ * Copyright: See LICENSE file that comes with this distribution
+ *
+ */
+
+#ifndef CUPP_KERNEL_IMPL_write_back_H
+#define CUPP_KERNEL_IMPL_write_back_H
+
+#if defined(__CUDACC__)
+#error "Not compatible with CUDA. Don't compile with nvcc."
+#endif
+
+// CUPP
+#include "cupp/common.h"
+#include "cupp/runtime.h"
+#include "cupp/completion.h"
+#include "cupp/device_reference.h"
+#include "cupp/kernel_call_traits.h"
+#include "cupp/kernel_impl/write_back_registry.h"
+
+// BOOST
+#include <boost/type_traits.hpp>
+
+
+namespace cupp {
+namespace kernel_impl {
+
+/**
+ * @class can_write_back_lazily
+ * @brief true if the value of a by-reference parameter can be written back to the host object without calling
+ *        @c kernel_call_traits::dirty(), i.e. the host object is a bitwise copy of the device object.
+ */
+template <typename host_type, typename device_type>
+struct can_write_back_lazily {
+	enum { value = boost::is_same<host_type, device_type>::value &&
+	               !impl::has_member_dirty< void (host_type::*)(device_reference<device_type>) >::value };
+};
+
+
+/**
+ * @class write_back_caller
+ * @brief Helper class used by @c write_back()
+ */
+template <bool lazy_possible>
+struct write_back_caller {
+	template <typename host_type, typename device_type>
+	static void call (host_type &that, const device_reference<device_type> &device_ref, const bool lazy) {
+		UNUSED_PARAMETER(lazy);
+		kernel_call_traits<host_type, device_type>::dirty(that, device_ref);
+	}
+};
+
+template <>
+struct write_back_caller<true> {
+	template <typename host_type, typename device_type>
+	static void call (host_type &that, const device_reference<device_type> &device_ref, const bool lazy) {
+		// without a scope, that may be gone before the value arrives
+		if (!lazy || !write_back_registry::instance().in_scope (&that)) {
+			kernel_call_traits<host_type, device_type>::dirty(that, device_ref);
+			return;
+		}
+
+		// enqueued before the launch gives its memory back, so the value is read before it can be overwritten
+		const completion c = copy_device_to_host_async (&that, device_ref.get_device_ptr(), 1, device_ref.get_stream().get());
+		write_back_registry::instance().add (&that, c);
+	}
+};
+
+
+/**
+ * @brief Writes the value of @a device_ref back to @a that, after a kernel got @a that by non-const reference.
+ *        If @a lazy is true, the type allows it and @a that is inside a @c cupp::write_back_scope, the transfer is
+ *        only enqueued, see @c write_back_registry.
+ */
+template <typename host_type, typename device_type>
+inline void write_back (host_type &that, const device_reference<device_type> &device_ref, const bool lazy) {
+	write_back_caller< can_write_back_lazily<host_type, device_type>::value >::call (that, device_ref, lazy);
+}
+
+} // kernel_impl
+} // cupp
+
+#endif //CUPP_KERNEL_IMPL_write_back_H
@@ -0,0 +1,162 @@
+/*
+ * Copyright: See LICENSE file that comes with this distribution
+ *
+ */
+
+#ifndef CUPP_KERNEL_IMPL_write_back_registry_H
+#define CUPP_KERNEL_IMPL_write_back_registry_H
+
+#if defined(__CUDACC__)
+#error "Not compatible with CUDA. Don't compile with nvcc."
+#endif
+
+// CUPP
+#include "cupp/common.h"
+#include "cupp/completion.h"
+#include "cupp/staging_pool.h"
+
+// STD
+#include <cstddef> // Include std::size_t
+#include <map>
+
+
+namespace cupp {
+namespace kernel_impl {
+
+/**
+ * @class write_back_registry
+ * @platform Host only
+ * @brief Keeps track of the host objects, whose new value is still on its way back from the device.
+ *
+ * A kernel with lazy write-back (see @c cupp::kernel::set_lazy_write_back()) does not wait for the values of its
+ * by-reference parameters, it only enqueues their transfer back to the host and registers it here. The
+ * host object is stale until the transfer has been flushed, which happens when it is passed to the next kernel,
+ * by @c cupp::fetch(), by @c cupp::device::sync() and when its @c cupp::write_back_scope ends.
+ * Only host objects inside a scope are written back lazily, so no transfer outlives its host object.
+ *
+ * @warning This class is not thread safe, just like the rest of CuPP.
+ */
+class write_back_registry {
+	public: /***  CONSTRUCTORS & DESTRUCTORS  ***/
+		/**
+		 * @return The one and only registry
+		 */
+		static write_back_registry& instance() {
+			static write_back_registry registry;
+			return registry;
+		}
+
+	public:
+		/**
+		 * @brief Registers the transfer @a c, which writes the new value of @a host_object.
+		 *        A transfer registered before for the same object is flushed first.
+		 * @exception cuda_runtime_error
+		 */
+		void add (const void* host_object, const completion &c);
+
+		/**
+		 * @brief Blocks until the value of @a host_object has arrived on the host. Nothing happens, if there is no transfer for it.
+		 * @exception cuda_runtime_error
+		 */
+		void flush (const void* host_object);
+
+		/**
+		 * @brief Blocks until all registered values have arrived on the host
+		 * @exception cuda_runtime_error
+		 */
+		void flush_all ();
+
+		/**
+		 * @return true if no transfer is pending
+		 */
+		bool empty () const { return pending_.empty(); }
+
+		/**
+		 * @brief Allows the value of @a host_object to be written back lazily, until @c close_scope() is called for it
+		 */
+		void open_scope (const void* host_object) { ++scopes_[host_object]; }
+
+		/**
+		 * @brief Ends a scope opened by @c open_scope(), the last one flushes the transfer of @a host_object.
+		 *        Errors are ignored, as this is called by a destructor.
+		 */
+		void close_scope (const void* host_object);
+
+		/**
+		 * @return true if the value of @a host_object may be written back lazily
+		 */
+		bool in_scope (const void* host_object) const { return scopes_.find(host_object) != scopes_.end(); }
+
+	private:
+		/**
+		 * The pending transfers outlive the staging buffers they return, so the pool has to be created before us.
+		 */
+		write_back_registry() { staging_pool::instance(); }
+
+		// not copyable
+		write_back_registry (const write_back_registry&);
+		write_back_registry& operator= (const write_back_registry&);
+
+	private:
+		/**
+		 * The pending transfers, indexed by their host object
+		 */
+		std::map<const void*, completion> pending_;
+
+		/**
+		 * The number of open scopes per host object
+		 */
+		std::map<const void*, std::size_t> scopes_;
+};
+
+
+inline void write_back_registry::add (const void* host_object, const completion &c) {
+	flush (host_object);
+	pending_.insert (std::make_pair(host_object, c));
+}
+
+
+inline void write_back_registry::flush (const void* host_object) {
+	if (pending_.empty()) {
+		return;
+	}
+
+	std::map<const void*, completion>::iterator it = pending_.find(host_object);
+	if (it == pending_.end()) {
+		return;
+	}
+
+	const completion c = it->second;
+	pending_.erase(it);
+	c.wait();
+}
+
+
+inline void write_back_registry::close_scope (const void* host_object) {
+	std::map<const void*, std::size_t>::iterator it = scopes_.find(host_object);
+	if (it == scopes_.end() || --it->second != 0) {
+		return;
+	}
+	scopes_.erase(it);
+
+	try {
+		flush (host_object);
+	} catch (...) {
+		// we can not report errors here
+	}
+}
+
+
+inline void write_back_registry::flush_all () {
+	std::map<const void*, completion> pending;
+	pending.swap(pending_);
+
+	for (std::map<const void*, completion>::const_iterator it = pending.begin(); it != pending.end(); ++it) {
+		it->second.wait();
+	}
+}
+
+} // kernel_impl
+} // cupp
+
+#endif //CUPP_KERNEL_IMPL_write_back_registry_H
@@ -0,0 +1,562 @@
+/*
+ * Copyright: See LICENSE file that comes with this distribution
+ *
+ */
+
+#ifndef CUPP_kernel_profiler_H
+#define CUPP_kernel_profiler_H
+
+#if defined(__CUDACC__)
+#error "Not compatible with CUDA. Don't compile with nvcc."
+#endif
+
+// CUPP
+#include "cupp/common.h"
+#include "cupp/exception/cuda_runtime_error.h"
+
+// STD
+#include <cstddef> // Include std::size_t
+#include <algorithm> // Include std::sort, std::min, std::max
+#include <cmath> // Include std::ceil
+#include <list>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// CUDA
+#include <cuda_runtime.h>
+#include <vector_types.h>
+
+
+namespace cupp {
+
+/**
+ * @class kernel_profiler
+ * @platform Host only
+ * @brief Measures the time the kernels spend on the device, by recording a device event before and after
+ *        every launch done by @c kernel and @c typed_kernel.
+ *
+ * The profiler is disabled by default and costs a single test per launch then. The events are read lazily, a
+ * launch is never waited for: finished measurements are collected during later launches, the remaining ones
+ * when @c stats() or @c report() is called.
+ * To keep the overhead low only every Nth launch of a kernel can be timed (see @c set_sample_interval()),
+ * every launch is still counted. At most @c max_samples() times are kept per kernel for the percentiles.
+ *
+ * @example kernel_profiler::instance().enable(); ...; kernel_profiler::instance().report(std::cout);
+ * @warning This class is not thread safe, just like the rest of CuPP.
+ */
+class kernel_profiler {
+	public:
+		/**
+		 * @struct launch_config
+		 * @brief The grid and block size of a launch
+		 */
+		struct launch_config {
+			dim3 grid;
+			dim3 block;
+
+			bool operator< (const launch_config &other) const;
+		};
+
+		/**
+		 * @struct statistics
+		 * @brief Everything we know about the launches of one kernel
+		 */
+		struct statistics {
+			statistics() : calls(0), timed_calls(0), total_ms(0.0), min_ms(0.0f), max_ms(0.0f), times_stride(1) {}
+
+			/**
+			 * @return The average time of the timed launches in milliseconds
+			 */
+			double mean_ms() const { return timed_calls == 0 ? 0.0 : total_ms / timed_calls; }
+
+			/**
+			 * @return The time not exceeded by @a p percent of the timed launches in milliseconds, e.g. 50 for the median
+			 */
+			float percentile_ms (const double p) const;
+
+			/**
+			 * Number of launches
+			 */
+			std::size_t calls;
+
+			/**
+			 * Number of launches timed, every Nth launch if a sample interval is set
+			 */
+			std::size_t timed_calls;
+
+			/**
+			 * Time of all timed launches in milliseconds
+			 */
+			double total_ms;
+
+			/**
+			 * The fastest and slowest timed launch in milliseconds
+			 */
+			float min_ms;
+			float max_ms;
+
+			/**
+			 * The time of every @a times_stride th timed launch in milliseconds, the first one included
+			 */
+			std::vector<float> times_ms;
+
+			/**
+			 * Doubled whenever @a times_ms exceeds @c kernel_profiler::max_samples(), so it is spread evenly over
+			 * all timed launches
+			 */
+			std::size_t times_stride;
+
+			/**
+			 * Number of launches per grid and block size
+			 */
+			std::map<launch_config, std::size_t> configs;
+		};
+
+	public: /***  CONSTRUCTORS & DESTRUCTORS  ***/
+		/**
+		 * @return The one and only profiler
+		 */
+		static kernel_profiler& instance() {
+			static kernel_profiler p;
+			return p;
+		}
+
+		~kernel_profiler();
+
+	public:
+		/**
+		 * @brief Starts profiling
+		 */
+		void enable() { enabled_ = true; }
+
+		/**
+		 * @brief Stops profiling, the statistics collected so far are kept
+		 */
+		void disable() { enabled_ = false; }
+
+		/**
+		 * @return true if launches are profiled
+		 */
+		bool enabled() const { return enabled_; }
+
+		/**
+		 * @brief Times only every @a n th launch of a kernel, 1 (the default) times every launch
+		 */
+		void set_sample_interval (const std::size_t n) { sample_interval_ = n == 0 ? 1 : n; }
+
+		/**
+		 * @return Every how many launches a kernel is timed
+		 */
+		std::size_t sample_interval() const { return sample_interval_; }
+
+		/**
+		 * @brief Keeps at most @a n times per kernel for the percentiles, 10000 by default.
+		 *        The total, mean, minimum and maximum always include every timed launch.
+		 */
+		void set_max_samples (const std::size_t n) { max_samples_ = n == 0 ? 1 : n; }
+
+		/**
+		 * @return How many times per kernel are kept at most
+		 */
+		std::size_t max_samples() const { return max_samples_; }
+
+		/**
+		 * @brief Names the kernel @a func in the report, otherwise its address is printed
+		 */
+		template <typename F_type>
+		void set_name (F_type func, const std::string &name) { names_[(const void*)func] = name; }
+
+		/**
+		 * @brief Forgets all statistics collected so far
+		 */
+		void clear();
+
+		/**
+		 * @brief Measures the launches still pending and destroys the events of the device @a device_id
+		 * @note Must be called before the context of the device is destroyed, as the events die with it.
+		 */
+		void device_reset (const int device_id);
+
+		/**
+		 * @return The statistics of the kernel @a func, waits for its launches still running
+		 * @exception cuda_runtime_error
+		 */
+		template <typename F_type>
+		statistics stats (F_type func) { return stats_of ((const void*)func); }
+
+		/**
+		 * @brief Writes one line per kernel to @a out, waits for the launches still running
+		 * @exception cuda_runtime_error
+		 */
+		void report (std::ostream &out);
+
+	public: /***  USED BY kernel_impl::timed_launch  ***/
+		/**
+		 * @return true if this launch of @a func is to be timed
+		 */
+		bool sample (const void* func);
+
+		/**
+		 * @return An event to record a launch on the current device @a device_id with
+		 * @exception cuda_runtime_error
+		 */
+		cudaEvent_t acquire_event (const int device_id);
+
+		/**
+		 * @brief Puts @a e, created by @c acquire_event(device_id), back to be used by a later launch on @a device_id
+		 */
+		void release_event (cudaEvent_t e, const int device_id) { free_events_[device_id].push_back(e); }
+
+		/**
+		 * @brief Counts a launch of @a func, @a start and @a stop bracket it if it is timed (0 otherwise).
+		 *        The events, acquired for @a device_id, are released when the launch has been measured.
+		 */
+		void record (const void* func, const dim3 &grid_dim, const dim3 &block_dim, const int device_id, cudaEvent_t start, cudaEvent_t stop);
+
+	private:
+		/**
+		 * @brief A timed launch, whose events have not been read yet
+		 */
+		struct pending_launch {
+			const void* func;
+			int device_id;
+			cudaEvent_t start;
+			cudaEvent_t stop;
+		};
+
+		kernel_profiler() : enabled_(false), sample_interval_(1), max_samples_(10000) {}
+
+		// not copyable
+		kernel_profiler (const kernel_profiler&);
+		kernel_profiler& operator= (const kernel_profiler&);
+
+		/**
+		 * @brief Reads the events of the pending launches, if @a wait is false only of the finished ones
+		 * @exception cuda_runtime_error
+		 */
+		void collect (const bool wait);
+
+		/**
+		 * @brief Adds the measurement of @a p to our statistics, releases its events
+		 * @exception cuda_runtime_error
+		 */
+		void measure (const pending_launch &p);
+
+		statistics stats_of (const void* func);
+
+	private:
+		/**
+		 * true means launches are profiled
+		 */
+		bool enabled_;
+
+		/**
+		 * Every how many launches a kernel is timed
+		 */
+		std::size_t sample_interval_;
+
+		/**
+		 * How many times per kernel are kept at most
+		 */
+		std::size_t max_samples_;
+
+		/**
+		 * Our statistics, one per kernel
+		 */
+		std::map<const void*, statistics> stats_;
+
+		/**
+		 * The names set by @c set_name()
+		 */
+		std::map<const void*, std::string> names_;
+
+		/**
+		 * The timed launches not measured yet, oldest first
+		 */
+		std::list<pending_launch> pending_;
+
+		/**
+		 * Events not in use, created by earlier launches, per device (an event can only be recorded on its device)
+		 */
+		std::map<int, std::vector<cudaEvent_t> > free_events_;
+};
+
+
+inline bool kernel_profiler::launch_config::operator< (const launch_config &other) const {
+	const unsigned int a[6] = { grid.x, grid.y, grid.z, block.x, block.y, block.z };
+	const unsigned int b[6] = { other.grid.x, other.grid.y, other.grid.z, other.block.x, other.block.y, other.block.z };
+	return std::lexicographical_compare (a, a+6, b, b+6);
+}
+
+
+inline float kernel_profiler::statistics::percentile_ms (const double p) const {
+	if (times_ms.empty()) {
+		return 0.0f;
+	}
+
+	std::vector<float> sorted (times_ms);
+	std::sort (sorted.begin(), sorted.end());
+
+	// nearest rank
+	const double rank = std::ceil (p / 100.0 * sorted.size());
+	const std::size_t index = rank <= 1.0 ? 0 : static_cast<std::size_t>(rank) - 1;
+	return sorted[std::min (index, sorted.size() - 1)];
+}
+
+
+inline kernel_profiler::~kernel_profiler() {
+	// the device may already be gone at exit, so errors are ignored
+	for (std::list<pending_launch>::iterator it = pending_.begin(); it != pending_.end(); ++it) {
+		cudaEventDestroy (it->start);
+		cudaEventDestroy (it->stop);
+	}
+	for (std::map<int, std::vector<cudaEvent_t> >::iterator d = free_events_.begin(); d != free_events_.end(); ++d) {
+		for (std::vector<cudaEvent_t>::iterator it = d->second.begin(); it != d->second.end(); ++it) {
+			cudaEventDestroy (*it);
+		}
+	}
+}
+
+
+inline void kernel_profiler::clear() {
+	collect (true);
+	stats_.clear();
+}
+
+
+inline void kernel_profiler::device_reset (const int device_id) {
+	// the device may already be in a bad state, so errors are ignored
+	try {
+		collect (true);
+	} catch (...) {
+	}
+
+	for (std::list<pending_launch>::iterator it = pending_.begin(); it != pending_.end(); ) {
+		if (it->device_id == device_id) {
+			cudaEventDestroy (it->start);
+			cudaEventDestroy (it->stop);
+			it = pending_.erase(it);
+		} else {
+			++it;
+		}
+	}
+
+	const std::map<int, std::vector<cudaEvent_t> >::iterator free_events = free_events_.find(device_id);
+	if (free_events != free_events_.end()) {
+		for (std::vector<cudaEvent_t>::iterator it = free_events->second.begin(); it != free_events->second.end(); ++it) {
+			cudaEventDestroy (*it);
+		}
+		free_events_.erase(free_events);
+	}
+}
+
+
+inline bool kernel_profiler::sample (const void* func) {
+	const statistics &s = stats_[func];
+	return s.calls % sample_interval_ == 0;
+}
+
+
+inline cudaEvent_t kernel_profiler::acquire_event (const int device_id) {
+	std::vector<cudaEvent_t> &free_events = free_events_[device_id];
+	if (!free_events.empty()) {
+		const cudaEvent_t e = free_events.back();
+		free_events.pop_back();
+		return e;
+	}
+
+	cudaEvent_t e;
+	if (cudaEventCreate (&e) != cudaSuccess) {
+		throw exception::cuda_runtime_error(cudaGetLastError());
+	}
+	return e;
+}
+
+
+inline void kernel_profiler::record (const void* func, const dim3 &grid_dim, const dim3 &block_dim, const int device_id, cudaEvent_t start, cudaEvent_t stop) {
+	statistics &s = stats_[func];
+	++s.calls;
+
+	launch_config config;
+	config.grid  = grid_dim;
+	config.block = block_dim;
+	++s.configs[config];
+
+	if (start != 0) {
+		pending_launch p;
+		p.func      = func;
+		p.device_id = device_id;
+		p.start     = start;
+		p.stop      = stop;
+		pending_.push_back(p);
+
+		// the events of the launches finished meanwhile can be reused
+		collect (false);
+	}
+}
+
+
+inline void kernel_profiler::collect (const bool wait) {
+	for (std::list<pending_launch>::iterator it = pending_.begin(); it != pending_.end(); ) {
+		if (wait) {
+			if (cudaEventSynchronize (it->stop) != cudaSuccess) {
+				throw exception::cuda_runtime_error(cudaGetLastError());
+			}
+		} else {
+			const cudaError_t error = cudaEventQuery (it->stop);
+			if (error == cudaErrorNotReady) {
+				// launches in other streams may have finished
+				++it;
+				continue;
+			}
+			if (error != cudaSuccess) {
+				throw exception::cuda_runtime_error(error);
+			}
+		}
+
+		const pending_launch p = *it;
+		it = pending_.erase(it);
+		measure (p);
+	}
+}
+
+
+inline void kernel_profiler::measure (const pending_launch &p) {
+	float ms = 0.0f;
+	const cudaError_t error = cudaEventElapsedTime (&ms, p.start, p.stop);
+
+	release_event (p.start, p.device_id);
+	release_event (p.stop, p.device_id);
+
+	if (error != cudaSuccess) {
+		throw exception::cuda_runtime_error(error);
+	}
+
+	statistics &s = stats_[p.func];
+	s.min_ms = s.timed_calls == 0 ? ms : std::min (s.min_ms, ms);
+	s.max_ms = s.timed_calls == 0 ? ms : std::max (s.max_ms, ms);
+	s.total_ms += ms;
+
+	if (s.timed_calls % s.times_stride == 0) {
+		s.times_ms.push_back(ms);
+
+		// too many times, keep every other one
+		if (s.times_ms.size() > max_samples_) {
+			for (std::size_t i = 0; 2*i < s.times_ms.size(); ++i) {
+				s.times_ms[i] = s.times_ms[2*i];
+			}
+			s.times_ms.resize ((s.times_ms.size() + 1) / 2);
+			s.times_stride *= 2;
+		}
+	}
+	++s.timed_calls;
+}
+
+
+inline kernel_profiler::statistics kernel_profiler::stats_of (const void* func) {
+	collect (true);
+
+	std::map<const void*, statistics>::const_iterator it = stats_.find(func);
+	if (it == stats_.end()) {
+		return statistics();
+	}
+	return it->second;
+}
+
+
+inline void kernel_profiler::report (std::ostream &out) {
+	collect (true);
+
+	for (std::map<const void*, statistics>::const_iterator it = stats_.begin(); it != stats_.end(); ++it) {
+		const statistics &s = it->second;
+
+		const std::map<const void*, std::string>::const_iterator name = names_.find(it->first);
+		if (name != names_.end()) {
+			out << name->second;
+		} else {
+			out << it->first;
+		}
+
+		out << ": calls=" << s.calls << " timed=" << s.timed_calls
+		    << " total=" << s.total_ms << "ms mean=" << s.mean_ms() << "ms min=" << s.min_ms << "ms max=" << s.max_ms
+		    << "ms p50=" << s.percentile_ms(50) << "ms p95=" << s.percentile_ms(95) << "ms p99=" << s.percentile_ms(99) << "ms";
+
+		for (std::map<launch_config, std::size_t>::const_iterator c = s.configs.begin(); c != s.configs.end(); ++c) {
+			out << " grid=" << c->first.grid.x << "x" << c->first.grid.y << "x" << c->first.grid.z
+			    << " block=" << c->first.block.x << "x" << c->first.block.y << "x" << c->first.block.z
+			    << " (" << c->second << ")";
+		}
+
+		out << "\n";
+	}
+}
+
+
+namespace kernel_impl {
+
+/**
+ * @class timed_launch
+ * @brief Brackets a kernel launch with two device events, if the @c kernel_profiler is enabled.
+ *        Constructed right before the launch, @c launched() is called after it succeeded.
+ *        A launch that failed is neither counted nor timed.
+ */
+class timed_launch {
+	public:
+		timed_launch (const void* func, const dim3 &grid_dim, const dim3 &block_dim, cudaStream_t stream) :
+			enabled_(kernel_profiler::instance().enabled()), func_(func), grid_dim_(grid_dim), block_dim_(block_dim), stream_(stream), device_id_(0), start_(0), stop_(0)
+		{
+			if (enabled_ && kernel_profiler::instance().sample(func_)) {
+				if (cudaGetDevice (&device_id_) != cudaSuccess) {
+					throw exception::cuda_runtime_error(cudaGetLastError());
+				}
+				start_ = kernel_profiler::instance().acquire_event (device_id_);
+				stop_  = kernel_profiler::instance().acquire_event (device_id_);
+				if (cudaEventRecord (start_, stream_) != cudaSuccess) {
+					throw exception::cuda_runtime_error(cudaGetLastError());
+				}
+			}
+		}
+
+		/**
+		 * @exception cuda_runtime_error
+		 */
+		void launched() {
+			if (!enabled_) {
+				return;
+			}
+			if (start_ != 0 && cudaEventRecord (stop_, stream_) != cudaSuccess) {
+				throw exception::cuda_runtime_error(cudaGetLastError());
+			}
+
+			// the profiler owns the events now
+			const cudaEvent_t start = start_;
+			const cudaEvent_t stop  = stop_;
+			start_ = stop_ = 0;
+			kernel_profiler::instance().record (func_, grid_dim_, block_dim_, device_id_, start, stop);
+		}
+
+		~timed_launch() {
+			if (start_ != 0) {
+				kernel_profiler::instance().release_event (start_, device_id_);
+				kernel_profiler::instance().release_event (stop_, device_id_);
+			}
+		}
+
+	private:
+		const bool enabled_;
+		const void* func_;
+		const dim3 grid_dim_;
+		const dim3 block_dim_;
+		cudaStream_t stream_;
+		int device_id_;
+		cudaEvent_t start_;
+		cudaEvent_t stop_;
+};
+
+} // namespace kernel_impl
+
+} // namespace cupp
+
+#endif
@@ -13,6 +13,7 @@
 // CUPP
 #include "cupp/common.h"
 #include "cupp/runtime.h"
+#include "cupp/completion.h"
 #include "cupp/kernel_type_binding.h"
 #include "cupp/shared_device_pointer.h"
 #include "cupp/device_reference.h"
@@ -225,11 +226,75 @@ class memory1d {
 		template <typename OutputIterator>
 		void copy_to_host( OutputIterator out_iter );
 
+		/**
+		 * @brief Copies @a count elements starting at element @a offset from the memory on the device to @a destination
+		 * @param count How many elements will be copied
+		 * @param destination The place where you want to store the data
+		 * @param offset Is non-byte offset (TM)
+		 * @param stream The stream the copy is enqueued in, only it is waited for
+		 * @warning Be sure that @a destination points to at least @a count many elements.
+		 * @platform Host only
+		 */
+		void copy_to_host( size_type count, T* destination, size_type offset, cudaStream_t stream=0 );
+
+		/**
+		 * @brief Starts copying data to the memory on the device
+		 * @param data The data which will get transfered to the device
+		 * @param stream The stream the copy is enqueued in
+		 * @return A handle to wait for the copy. The memory of @a this is kept alive until the copy has finished.
+		 * @warning Be sure that @a data points to at least @a this.size() many elements.
+		 * @note @a data may be changed as soon as this function returns.
+		 * @platform Host only
+		 */
+		completion copy_to_device_async( T const* data, cudaStream_t stream=0 );
+
+		/**
+		 * @brief Starts copying data to the memory on the device
+		 * @param count How many data you want to transfer
+		 * @param data The data which will get transfered to the device
+		 * @param offset Is non-byte offset (TM)
+		 * @param stream The stream the copy is enqueued in
+		 * @return A handle to wait for the copy. The memory of @a this is kept alive until the copy has finished.
+		 * @warning Be sure that @a data points to at least @a count() many elements.
+		 * @platform Host only
+		 */
+		completion copy_to_device_async( size_type count, T const* data, size_type offset=0, cudaStream_t stream=0 );
+
+		/**
+		 * @brief Starts copying data from the memory on the device to @a destination
+		 * @param destination The place where you want to store the data
+		 * @param stream The stream the copy is enqueued in
+		 * @return A handle to wait for the copy. The memory of @a this is kept alive until the copy has finished.
+		 * @warning Be sure that @a destination points to at least @c size() many elements and stays alive until
+		 *          the returned completion has been waited for.
+		 * @platform Host only
+		 */
+		completion copy_to_host_async( T* destination, cudaStream_t stream=0 );
+
+		/**
+		 * @brief Starts copying @a count elements starting at element @a offset from the memory on the device to @a destination
+		 * @param count How many elements will be copied
+		 * @param destination The place where you want to store the data
+		 * @param offset Is non-byte offset (TM)
+		 * @param stream The stream the copy is enqueued in
+		 * @return A handle to wait for the copy. The memory of @a this is kept alive until the copy has finished.
+		 * @warning Be sure that @a destination points to at least @a count many elements and stays alive until
+		 *          the returned completion has been waited for.
+		 * @platform Host only
+		 */
+		completion copy_to_host_async( size_type count, T* destination, size_type offset, cudaStream_t stream=0 );
+
 		/**
 		 * @return A shared device pointer to the memory handled by @a this
 		 */
 		shared_device_pointer<T> cuda_pointer() const {  return device_pointer_;  }
 
+		/**
+		 * @brief Tells the @c caching_allocator that work enqueued in @a s uses our memory and our proxy
+		 * @note Transfers with an explicit stream are not counted on their own, the caller passes their stream here.
+		 */
+		void use_in (const stream &s) const;
+
 		/**
 		 * @return the device the memory is allocated on
 		 */
@@ -300,22 +365,34 @@ device_reference< typename memory1d<T>::device_type > memory1d<T>::get_device_re
 		device_ref_ = new device_reference < device_type > (d, transform(d) );
 	}
 
+	// the kernel runs in the current stream
+	use_in (impl::current_stream());
+
 	return *device_ref_;
 }
 
 
 template <typename T>
-memory1d<T>::memory1d( device const& dev, size_type size ) : device_pointer_( cupp::malloc<T>(size) ), size_(size), device_ref_(0), d_(dev) {}
+void memory1d<T>::use_in (const stream &s) const {
+	caching_allocator::instance().use_in_stream (device_pointer_.get(), s);
+	if (device_ref_ != 0) {
+		device_ref_ -> use_in (s);
+	}
+}
+
+
+template <typename T>
+memory1d<T>::memory1d( device const& dev, size_type size ) : device_pointer_( cupp::malloc<T>(size, "memory1d") ), size_(size), device_ref_(0), d_(dev) {}
 
 
 template <typename T>
-memory1d<T>::memory1d( device const& dev, int init_value, size_type size ) : device_pointer_( cupp::malloc<T>(size) ), size_(size), device_ref_(0), d_(dev) {
+memory1d<T>::memory1d( device const& dev, int init_value, size_type size ) : device_pointer_( cupp::malloc<T>(size, "memory1d") ), size_(size), device_ref_(0), d_(dev) {
 	set(init_value);
 }
 
 
 template <typename T>
-memory1d<T>::memory1d( device const& dev, T const* data, size_type size ) : device_pointer_( cupp::malloc<T>(size) ), size_(size), device_ref_(0), d_(dev) {
+memory1d<T>::memory1d( device const& dev, T const* data, size_type size ) : device_pointer_( cupp::malloc<T>(size, "memory1d") ), size_(size), device_ref_(0), d_(dev) {
 	UNUSED_PARAMETER(dev);
 	copy_to_device(data);
 }
@@ -326,12 +403,12 @@ template <typename InputIterator>
 memory1d<T>::memory1d( device const& dev, InputIterator first, InputIterator last ): device_ref_(0), d_(dev) {
 	size_ = last - first;
 	
-	device_pointer_( cupp::malloc<T>(size_) );
+	device_pointer_( cupp::malloc<T>(size_, "memory1d") );
 	copy_to_device(first, last);
 }
 
 template <typename T>
-memory1d<T>::memory1d( memory1d<T> const& other ) : device_pointer_( cupp::malloc<T>(other.size()) ), size_(other.size()), device_ref_(0), d_(other.get_device()) {
+memory1d<T>::memory1d( memory1d<T> const& other ) : device_pointer_( cupp::malloc<T>(other.size(), "memory1d") ), size_(other.size()), device_ref_(0), d_(other.get_device()) {
 	copy_to_device(other);
 }
 
@@ -399,6 +476,52 @@ void memory1d<T>::copy_to_host (T* destination) {
 }
 
 
+template <typename T>
+completion memory1d<T>::copy_to_device_async( T const* data, cudaStream_t stream ) {
+	return copy_to_device_async(size(), data, 0, stream);
+}
+
+
+template <typename T>
+completion memory1d<T>::copy_to_device_async( size_type count, T const* data, size_type offset, cudaStream_t stream ) {
+	if (count + offset > size()) {
+		throw exception::memory_access_violation();
+	}
+
+	completion returnee = cupp::copy_host_to_device_async (device_pointer_.get()+offset, data, count, stream);
+	returnee.keep_alive(boost::any(device_pointer_));
+	return returnee;
+}
+
+
+template <typename T>
+completion memory1d<T>::copy_to_host_async( T* destination, cudaStream_t stream ) {
+	return cupp::copy_device_to_host_async (destination, device_pointer_, size(), stream);
+}
+
+
+template <typename T>
+void memory1d<T>::copy_to_host( size_type count, T* destination, size_type offset, cudaStream_t stream ) {
+	if (count + offset > size()) {
+		throw exception::memory_access_violation();
+	}
+
+	cupp::copy_device_to_host (destination, device_pointer_.get()+offset, count, stream);
+}
+
+
+template <typename T>
+completion memory1d<T>::copy_to_host_async( size_type count, T* destination, size_type offset, cudaStream_t stream ) {
+	if (count + offset > size()) {
+		throw exception::memory_access_violation();
+	}
+
+	completion returnee = cupp::copy_device_to_host_async (destination, device_pointer_.get()+offset, count, stream);
+	returnee.keep_alive(boost::any(device_pointer_));
+	return returnee;
+}
+
+
 template <typename T>
 template <typename OutputIterator>
 void memory1d<T>::copy_to_host(OutputIterator out_iter) {
@@ -12,8 +12,18 @@
 
 // CUPP
 #include "cupp/common.h"
+#include "cupp/caching_allocator.h"
+#include "cupp/staging_pool.h"
+#include "cupp/completion.h"
+#include "cupp/tracer.h"
 #include "cupp/exception/cuda_runtime_error.h"
 
+// STD
+#include <cstring> // Include std::memcpy
+#include <map>
+#include <utility> // Include std::pair
+#include <vector>
+
 // CUDA
 #include <cuda_runtime.h>
 
@@ -28,11 +38,14 @@ void mem_set(T* device_pointer, int value, const size_t size=1);
 template <typename T>
 void mem_set(shared_device_pointer<T> device_pointer, int value, const size_t size=1);
 
-inline void* malloc_ (const unsigned int size_in_b);
+inline void* malloc_ (const size_t size_in_b);
 
 template <typename T>
 T* malloc(const size_t size=1);
 
+template <typename T>
+T* malloc(const size_t size, const char* tag);
+
 template <typename T>
 void free(T* device_pointer);
 
@@ -59,11 +72,29 @@ void copy_device_to_device(shared_device_pointer<T> destination, const shared_de
 
 
 template <typename T>
-void copy_device_to_host(T* destination, const T * const source, size_t count=1);
+void copy_device_to_host(T* destination, const T * const source, size_t count=1, cudaStream_t stream=0);
+
 
+template <typename T>
+void copy_device_to_host(T* destination, const shared_device_pointer<T> source, size_t count=1, cudaStream_t stream=0);
+
+template <typename T>
+completion copy_host_to_device_async(T *destination, const T * const source, size_t count=1, cudaStream_t stream=0);
+
+template <typename T>
+completion copy_host_to_device_async(shared_device_pointer<T> destination, const T * const source, size_t count=1, cudaStream_t stream=0);
+
+template <typename T>
+completion copy_device_to_device_async(T* destination, const T * const source, size_t count=1, cudaStream_t stream=0);
+
+template <typename T>
+completion copy_device_to_device_async(shared_device_pointer<T> destination, const shared_device_pointer<T> source, size_t count=1, cudaStream_t stream=0);
 
 template <typename T>
-void copy_device_to_host(T* destination, const shared_device_pointer<T> source, size_t count=1);
+completion copy_device_to_host_async(T* destination, const T * const source, size_t count=1, cudaStream_t stream=0);
+
+template <typename T>
+completion copy_device_to_host_async(T* destination, const shared_device_pointer<T> source, size_t count=1, cudaStream_t stream=0);
 
 inline void thread_synchronize();
 
@@ -85,12 +116,12 @@ void mem_set(shared_device_pointer<T> device_pointer, int value, const size_t si
 	mem_set(device_pointer.get(), value, size);
 }
 
+/**
+ * Allocates @a size_in_b bytes of global memory. The memory is taken from the @c caching_allocator,
+ * so in the steady state no call to cudaMalloc is needed.
+ */
 inline void* malloc_ (const size_t size_in_b) {
-	void* temp;
-	if (cudaMalloc( &temp, size_in_b ) != cudaSuccess) {
-		throw exception::cuda_runtime_error(cudaGetLastError());
-	}
-	return temp;
+	return caching_allocator::instance().allocate(size_in_b);
 }
 
 template <typename T>
@@ -98,20 +129,44 @@ T* malloc(const size_t size) {
 	return static_cast<T*> (malloc_ (size*sizeof(T)));
 }
 
+/**
+ * Allocates @a size elements of type @a T for the data structure @a tag (see @c impl::allocation_tag)
+ */
+template <typename T>
+T* malloc(const size_t size, const char* tag) {
+	impl::allocation_tag guard (tag);
+	return malloc<T>(size);
+}
+
 
+/**
+ * Gives @a device_pointer back to the @c caching_allocator, which keeps it for the next allocation.
+ */
 template <typename T>
 void free(T* device_pointer) {
-	if (cudaFree(device_pointer) != cudaSuccess) {
-		throw exception::cuda_runtime_error(cudaGetLastError());
-	}
+	caching_allocator::instance().deallocate(device_pointer);
 }
 
 
+/**
+ * Copies @a count elements from the host to the device. Transfers of at least @c staging_pool::threshold()
+ * bytes are passed through the page-locked buffers of the @c staging_pool.
+ */
 template <typename T>
 void copy_host_to_device(T *destination, const T * const source, size_t count) {
-	if ( cudaMemcpy(destination, source, count * sizeof(T), cudaMemcpyHostToDevice) != cudaSuccess) {
+	staging_pool &pool = staging_pool::instance();
+	const size_t size_in_b = count * sizeof(T);
+	impl::trace_scope trace ("transfer", "copy_host_to_device", size_in_b);
+
+	if (size_in_b >= pool.threshold()) {
+		pool.copy_host_to_device(destination, source, size_in_b);
+		return;
+	}
+
+	if ( cudaMemcpy(destination, source, size_in_b, cudaMemcpyHostToDevice) != cudaSuccess) {
 		throw exception::cuda_runtime_error(cudaGetLastError());
 	}
+	pool.count_pageable(size_in_b, 0);
 }
 
 
@@ -123,6 +178,8 @@ void copy_host_to_device(shared_device_pointer<T> destination, const T * const s
 
 template <typename T>
 void copy_device_to_device(T* destination, const T * const source, size_t count) {
+	impl::trace_scope trace ("transfer", "copy_device_to_device", count * sizeof(T));
+
 	if ( cudaMemcpy(destination, source, count * sizeof(T), cudaMemcpyDeviceToDevice) != cudaSuccess) {
 		throw exception::cuda_runtime_error(cudaGetLastError());
 	}
@@ -147,20 +204,185 @@ void copy_device_to_device(shared_device_pointer<T> destination, const shared_de
 }
 
 
+/**
+ * Copies @a count elements from the device to the host in @a stream and waits for them. Transfers of at least
+ * @c staging_pool::threshold() bytes are passed through the page-locked buffers of the @c staging_pool.
+ * The default stream waits for all other streams, any other stream only for the work enqueued in it.
+ */
+template <typename T>
+void copy_device_to_host(T* destination, const T * const source, size_t count, cudaStream_t stream) {
+	staging_pool &pool = staging_pool::instance();
+	const size_t size_in_b = count * sizeof(T);
+	impl::trace_scope trace ("transfer", "copy_device_to_host", size_in_b);
+
+	if (size_in_b >= pool.threshold()) {
+		pool.copy_device_to_host(destination, source, size_in_b, stream);
+		return;
+	}
+
+	if (stream == 0) {
+		if (cudaMemcpy(destination, source, size_in_b, cudaMemcpyDeviceToHost) != cudaSuccess) {
+			throw exception::cuda_runtime_error(cudaGetLastError());
+		}
+	} else {
+		// a copy to pageable memory returns when the data has arrived
+		if (cudaMemcpyAsync(destination, source, size_in_b, cudaMemcpyDeviceToHost, stream) != cudaSuccess ||
+		    cudaStreamSynchronize(stream) != cudaSuccess) {
+			throw exception::cuda_runtime_error(cudaGetLastError());
+		}
+	}
+	pool.count_pageable(0, size_in_b);
+}
+
+
+template <typename T>
+void copy_device_to_host(T* destination, const shared_device_pointer<T> source, size_t count, cudaStream_t stream) {
+	copy_device_to_host(destination, source.get(), count, stream);
+}
+
+/**
+ * Starts copying @a count elements from the host to the device in @a stream.
+ * @a source is copied into a page-locked staging buffer before this function returns,
+ * so it may be changed right away.
+ */
+template <typename T>
+completion copy_host_to_device_async(T *destination, const T * const source, size_t count, cudaStream_t stream) {
+	staging_pool &pool = staging_pool::instance();
+	const size_t size_in_b = count * sizeof(T);
+	impl::trace_scope trace ("transfer", "copy_host_to_device_async", size_in_b);
+
+	void* staging = pool.acquire(size_in_b);
+	std::memcpy(staging, source, size_in_b);
+
+	if ( cudaMemcpyAsync(destination, staging, size_in_b, cudaMemcpyHostToDevice, stream) != cudaSuccess) {
+		pool.release(staging);
+		throw exception::cuda_runtime_error(cudaGetLastError());
+	}
+	pool.count_pinned(size_in_b, 0);
+
+	completion returnee(stream);
+	returnee.set_staging_buffer(staging);
+	return returnee;
+}
+
+
+/**
+ * Same as above, but @a destination is kept alive until the copy has finished.
+ */
+template <typename T>
+completion copy_host_to_device_async(shared_device_pointer<T> destination, const T * const source, size_t count, cudaStream_t stream) {
+	completion returnee = copy_host_to_device_async(destination.get(), source, count, stream);
+	returnee.keep_alive(boost::any(destination));
+	return returnee;
+}
+
+
+template <typename T>
+completion copy_device_to_device_async(T* destination, const T * const source, size_t count, cudaStream_t stream) {
+	impl::trace_scope trace ("transfer", "copy_device_to_device_async", count * sizeof(T));
+
+	if ( cudaMemcpyAsync(destination, source, count * sizeof(T), cudaMemcpyDeviceToDevice, stream) != cudaSuccess) {
+		throw exception::cuda_runtime_error(cudaGetLastError());
+	}
+	return completion(stream);
+}
+
+
+/**
+ * Same as above, but @a destination and @a source are kept alive until the copy has finished.
+ */
+template <typename T>
+completion copy_device_to_device_async(shared_device_pointer<T> destination, const shared_device_pointer<T> source, size_t count, cudaStream_t stream) {
+	completion returnee = copy_device_to_device_async(destination.get(), source.get(), count, stream);
+
+	std::vector< shared_device_pointer<T> > keep_alive;
+	keep_alive.push_back(destination);
+	keep_alive.push_back(source);
+	returnee.keep_alive(boost::any(keep_alive));
+	return returnee;
+}
+
+
+/**
+ * Starts copying @a count elements from the device to the host in @a stream.
+ * The data is written to @a destination by @c completion::wait() or @c completion::ready(),
+ * so @a destination must stay alive until then.
+ */
 template <typename T>
-void copy_device_to_host(T* destination, const T * const source, size_t count) {
-	if (cudaMemcpy(destination, source, count * sizeof(T), cudaMemcpyDeviceToHost) != cudaSuccess) {
+completion copy_device_to_host_async(T* destination, const T * const source, size_t count, cudaStream_t stream) {
+	staging_pool &pool = staging_pool::instance();
+	const size_t size_in_b = count * sizeof(T);
+	impl::trace_scope trace ("transfer", "copy_device_to_host_async", size_in_b);
+
+	void* staging = pool.acquire(size_in_b);
+
+	if (cudaMemcpyAsync(staging, source, size_in_b, cudaMemcpyDeviceToHost, stream) != cudaSuccess) {
+		pool.release(staging);
 		throw exception::cuda_runtime_error(cudaGetLastError());
 	}
+	pool.count_pinned(0, size_in_b);
+
+	completion returnee(stream);
+	returnee.set_staging_buffer(staging);
+	returnee.set_host_destination(destination, size_in_b);
+	return returnee;
 }
 
 
+/**
+ * Same as above, but @a source is kept alive until the copy has finished.
+ */
 template <typename T>
-void copy_device_to_host(T* destination, const shared_device_pointer<T> source, size_t count) {
-	if (cudaMemcpy(destination, source.get(), count * sizeof(T), cudaMemcpyDeviceToHost) != cudaSuccess) {
+completion copy_device_to_host_async(T* destination, const shared_device_pointer<T> source, size_t count, cudaStream_t stream) {
+	completion returnee = copy_device_to_host_async(destination, source.get(), count, stream);
+	returnee.keep_alive(boost::any(source));
+	return returnee;
+}
+
+#if CUDART_VERSION >= 4000
+/**
+ * @return true if the current device can access the memory of device @a peer directly.
+ *         Peer access is enabled the first time it is asked for, the result is cached.
+ */
+inline bool peer_access (const int peer) {
+	static std::map< std::pair<int, int>, bool > cache;
+
+	int cur_device = 0;
+	cudaGetDevice(&cur_device);
+
+	const std::pair<int, int> key (cur_device, peer);
+	std::map< std::pair<int, int>, bool >::const_iterator it = cache.find(key);
+	if (it != cache.end()) {
+		return it->second;
+	}
+
+	int can_access = 0;
+	if (peer != cur_device && cudaDeviceCanAccessPeer(&can_access, cur_device, peer) == cudaSuccess && can_access != 0) {
+		const cudaError_t error = cudaDeviceEnablePeerAccess(peer, 0);
+		if (error != cudaSuccess && error != cudaErrorPeerAccessAlreadyEnabled) {
+			can_access = 0;
+		}
+		// clear the error state, if access has already been enabled
+		cudaGetLastError();
+	}
+
+	return cache[key] = (can_access != 0);
+}
+
+/**
+ * Starts copying @a count elements from @a source on the device @a source_device to @a destination on the device @a destination_device
+ * @return A handle to wait for the copy
+ */
+template <typename T>
+completion copy_peer_async(T* destination, const int destination_device, const T * const source, const int source_device, size_t count, cudaStream_t stream) {
+	impl::trace_scope trace ("transfer", "copy_peer_async", count * sizeof(T));
+
+	if (cudaMemcpyPeerAsync(destination, destination_device, source, source_device, count * sizeof(T), stream) != cudaSuccess) {
 		throw exception::cuda_runtime_error(cudaGetLastError());
 	}
+	return completion(stream);
 }
+#endif
 
 /**
  * Synchronizes the calling thread with the asynchronius CUDA calls. You should never need to call this manually
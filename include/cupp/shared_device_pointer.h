@@ -37,11 +37,16 @@ namespace cupp {
 struct SharedPointerReferenceCount {
 	typedef size_t size_type;
 
-	explicit SharedPointerReferenceCount(): referenceCount_( 1 ) {
+	explicit SharedPointerReferenceCount( bool _owner = true ): referenceCount_( 1 ), owner_( _owner ) {
 		// Nothing to do.
 	}
 
 	size_type referenceCount_;
+
+	/**
+	* @c false if the memory is not freed together with the last pointer.
+	*/
+	bool owner_;
 };
 
 
@@ -94,6 +99,18 @@ public:
 		// Nothing to do.
 	}
 
+	/**
+	* Constructs a @c shared_device_pointer to @a _data, which is only freed if @a _owner is @c true.
+	* Used for memory owned by someone else, e.g. a @c kernel_impl::launch_arena.
+	*
+	* @post <code> use_count() == 1 </code> and <code>get() == _data )</code>
+	*
+	* @throw @c std::bad_alloc if memory could not be obtained.
+	*/
+	shared_device_pointer( T* _data, bool _owner ) : data_( _data ), referenceCount_( new SharedPointerReferenceCount( _owner ) ) {
+		// Nothing to do.
+	}
+
 	/**
 	* Constructs a @c shared_device_pointer that shares ownership with @a other.
 	*
@@ -262,7 +279,9 @@ private:
 
 		--( referenceCount_->referenceCount_ );
 		if ( 0 == referenceCount_->referenceCount_ ) {
-			cupp::free(data_);
+			if ( referenceCount_->owner_ ) {
+				cupp::free(data_);
+			}
 			data_ = 0;
 			delete referenceCount_;
 			referenceCount_ = 0;
@@ -0,0 +1,536 @@
+/*
+ * Copyright: See LICENSE file that comes with this distribution
+ *
+ */
+
+#ifndef CUPP_soa_vector_H
+#define CUPP_soa_vector_H
+
+#if defined(__CUDACC__)
+#error "Not compatible with CUDA. Don't compile with nvcc."
+#endif
+
+// CUPP
+#include "cupp/common.h"
+#include "cupp/runtime.h"
+#include "cupp/kernel_type_binding.h"
+#include "cupp/kernel_call_traits.h"
+#include "cupp/device.h"
+#include "cupp/device_reference.h"
+#include "cupp/shared_device_pointer.h"
+#include "cupp/stream.h"
+#include "cupp/completion.h"
+#include "cupp/dirty_ranges.h"
+#include "cupp/access.h"
+#include "cupp/tracer.h"
+
+#include "cupp/deviceT/soa_vector.h"
+
+// STD
+#include <algorithm> // Include std::max, std::min
+#include <vector>
+
+// BOOST
+#include <boost/static_assert.hpp>
+
+
+namespace cupp {
+
+namespace impl {
+
+/**
+ * @class for_each_soa_field
+ * @brief Calls @c f.visit<i>() for every field @a i of @a T
+ */
+template <typename T, int i = 0, int n = soa_fields<T>::size>
+struct for_each_soa_field {
+	template <typename F>
+	static void apply (F &f) {
+		f.template visit<i>();
+		for_each_soa_field<T, i+1, n>::apply(f);
+	}
+};
+
+template <typename T, int n>
+struct for_each_soa_field<T, n, n> {
+	template <typename F>
+	static void apply (F &f) {
+		UNUSED_PARAMETER(f);
+	}
+};
+
+} // namespace impl
+
+
+/**
+ * @class soa_vector
+ * @platform Host only
+ * @brief A vector, which stores its elements on the device as structure of arrays: every field declared by
+ *        @c CUPP_SOA_FIELDS and @c CUPP_SOA_FIELD gets its own array.
+ *
+ * On the host the elements are stored like in a std::vector, so they can be accessed as a whole. Like @c cupp::vector,
+ * only the elements changed on the host are transfered to the device, with one copy per field, and the data changed on
+ * the device is transfered back when the host accesses it. The fields not declared are not transfered.
+ * @example CUPP_SOA_FIELDS(particle, 2) CUPP_SOA_FIELD(particle, 0, float, x) CUPP_SOA_FIELD(particle, 1, float, v)
+ */
+template< typename T >
+class soa_vector {
+	public: /*** TYPEDEFS  ***/
+		typedef deviceT::soa_vector< T >                         device_type;
+		typedef soa_vector<T>                                    host_type;
+
+		typedef typename std::vector<T>::size_type               size_type;
+		typedef typename std::vector<T>::value_type              value_type;
+		typedef typename std::vector<T>::const_iterator          const_iterator;
+
+		enum {
+			/**
+			 * The number of fields stored in their own arrays
+			 */
+			fields = soa_fields<T>::size
+		};
+
+		// If you come here with a compiler error, you declared more fields than deviceT::soa_vector can store.
+		BOOST_STATIC_ASSERT(( static_cast<int>(fields) <= static_cast<int>(device_type::max_fields) ));
+
+	public: /***  The proxy class  ***/
+
+		/**
+		 * @class element_proxy
+		 * @brief This class is returned by @c cupp::soa_vector::operator[] to determine if an element inside the vector is changed.
+		 */
+		class element_proxy {
+			private: /***  Data elements  ***/
+				const size_type at_;
+				soa_vector<T>& vector_;
+
+			public: /***  Constructors & Destructors  ***/
+				element_proxy(const size_type at, soa_vector<T>& vector) :
+					at_(at), vector_(vector) {}
+
+			public: /***  Operators  ***/
+				operator T() const {
+					return get();
+				}
+
+				const T& get() const {
+					impl::trace_trigger trigger ("proxy");
+					vector_.update_host();
+					return vector_.data_[at_];
+				}
+
+				/**
+				 * @brief Access field @a i of the element, the element is marked as changed
+				 */
+				template <int i>
+				typename soa_field<T, i>::type& field() {
+					impl::trace_trigger trigger ("proxy");
+					vector_.update_host();
+					vector_.host_changes_.mark(at_);
+					return soa_field<T, i>::get(vector_.data_[at_]);
+				}
+
+				element_proxy& operator=(const element_proxy &rhs) {
+					return *this = rhs.get();
+				}
+
+				element_proxy& operator=(const T& rhs) {
+					impl::trace_trigger trigger ("proxy");
+					vector_.update_host();
+					vector_.host_changes_.mark(at_);
+					vector_.data_[at_] = rhs;
+					return *this;
+				}
+		};
+
+	public: /***  CONSTRUCTORS AND DESTRUCTORS  ***/
+
+		/**
+		 * @see @c std::vector
+		 */
+		soa_vector() : host_changes_(true), device_changes_(false), capacity_(0), device_size_(0) {}
+
+		/**
+		 * @see @c std::vector
+		 */
+		soa_vector( size_type num, const T& val = T() ) : data_(num, val), host_changes_(true), device_changes_(false), capacity_(0), device_size_(0) {}
+
+		/**
+		 * @brief Copies the elements of @a c, the device memory is not shared
+		 */
+		soa_vector( const soa_vector& c ) : host_changes_(true), device_changes_(false), capacity_(0), device_size_(0) {
+			c.update_host();
+			data_ = c.data_;
+		}
+
+	public: /***  OPERATORS  ***/
+		/**
+		 * @see @c std::vector
+		 */
+		element_proxy operator[]( size_type index ) {
+			return element_proxy (index, *this);
+		}
+
+		/**
+		 * @see @c std::vector
+		 */
+		const T& operator[]( size_type index ) const {
+			update_host();
+			return data_[index];
+		}
+
+		/**
+		 * @brief Copies the elements of @a c, the device memory is not shared
+		 */
+		soa_vector& operator=(const soa_vector& c) {
+			if (this != &c) {
+				c.update_host();
+				data_ = c.data_;
+				host_changes_.mark_all();
+
+				// our data have been overwritten ... ignore all old data on the device
+				device_changes_ = false;
+			}
+			return *this;
+		}
+
+	public: /***  NORMAL FUNCTIONS  ***/
+		/**
+		 * @see @c std::vector
+		 */
+		size_type size() const {
+			return data_.size();
+		}
+
+		/**
+		 * @see @c std::vector
+		 */
+		bool empty() const {
+			return data_.empty();
+		}
+
+		/**
+		 * @see @c std::vector
+		 */
+		const_iterator begin() const {
+			update_host();
+			return data_.begin();
+		}
+
+		/**
+		 * @see @c std::vector
+		 */
+		const_iterator end() const {
+			update_host();
+			return data_.end();
+		}
+
+		/**
+		 * @see @c std::vector
+		 */
+		void assign( size_type num, const T& val ) {
+			data_.assign (num, val);
+
+			host_changes_.mark_all();
+			// our data have been overwritten ... ignore all old data on the device
+			device_changes_ = false;
+		}
+
+		/**
+		 * @see @c std::vector
+		 */
+		void push_back( const T& val ) {
+			update_host();
+			data_.push_back(val);
+			host_changes_.mark(data_.size()-1);
+		}
+
+		/**
+		 * @see @c std::vector
+		 */
+		void pop_back() {
+			update_host();
+			data_.pop_back();
+		}
+
+		/**
+		 * @see @c std::vector
+		 */
+		void resize( size_type num, const T& val = T() ) {
+			update_host();
+			const size_type old_size = data_.size();
+			data_.resize (num, val);
+			host_changes_.mark(old_size, data_.size());
+		}
+
+		/**
+		 * @see @c std::vector
+		 */
+		void reserve( size_type size ) {
+			data_.reserve(size);
+		}
+
+		/**
+		 * @see @c std::vector
+		 */
+		void clear() {
+			data_.clear();
+			host_changes_.mark_all();
+			device_changes_ = false;
+		}
+
+	public: /*** CuPP kernel call traits implementation ***/
+		/**
+		 * @brief This function is called by the kernel_call_traits
+		 * @return A on the device useable soa_vector
+		 */
+		device_type transform (const device &d) {
+			update_device(d);
+
+			device_type returnee;
+			returnee.set_size (static_cast<typename device_type::size_type>(size()));
+			for (int i = 0; i < fields; ++i) {
+				returnee.set_field (i, memory_[i].get());
+			}
+			return returnee;
+		}
+
+		/**
+		 * @brief This function is called by the kernel_call_traits
+		 */
+		void dirty (device_reference< device_type > device_copy) {
+			UNUSED_PARAMETER(device_copy);
+
+			device_changes_ = true;
+			stream_ = impl::current_stream();
+		}
+
+	private:
+		/**
+		 * Allocates the array of every field on the device
+		 */
+		struct field_allocate {
+			soa_vector &vector_;
+
+			explicit field_allocate (soa_vector &vector) : vector_(vector) {}
+
+			template <int i>
+			void visit() {
+				typedef typename soa_field<T, i>::type field_type;
+				vector_.memory_[i] = shared_device_pointer<char> (cupp::malloc<char>(vector_.capacity_ * sizeof(field_type), "soa_vector"));
+			}
+		};
+
+		/**
+		 * Transfers the fields of the elements [begin, end) to their arrays on the device
+		 */
+		struct field_upload {
+			soa_vector &vector_;
+			const size_type begin_;
+			const size_type end_;
+
+			field_upload (soa_vector &vector, const size_type begin, const size_type end) : vector_(vector), begin_(begin), end_(end) {}
+
+			template <int i>
+			void visit() {
+				typedef typename soa_field<T, i>::type field_type;
+
+				std::vector<field_type> temp;
+				temp.reserve (end_ - begin_);
+				for (size_type k = begin_; k < end_; ++k) {
+					temp.push_back (soa_field<T, i>::get(vector_.data_[k]));
+				}
+
+				field_type* destination = reinterpret_cast<field_type*>(vector_.memory_[i].get()) + begin_;
+				if (vector_.stream_.get() == 0) {
+					cupp::copy_host_to_device (destination, &temp[0], temp.size());
+				} else {
+					// the data is staged, so temp may die right away
+					vector_.uploads_.push_back ( cupp::copy_host_to_device_async (destination, &temp[0], temp.size(), vector_.stream_.get()) );
+				}
+			}
+		};
+
+		/**
+		 * Transfers the arrays of the fields from the device into our elements
+		 */
+		struct field_download {
+			const soa_vector &vector_;
+
+			explicit field_download (const soa_vector &vector) : vector_(vector) {}
+
+			template <int i>
+			void visit() {
+				typedef typename soa_field<T, i>::type field_type;
+
+				std::vector<field_type> temp (vector_.device_size_);
+
+				// only wait for the stream that changed our data
+				const field_type* source = reinterpret_cast<const field_type*>(vector_.memory_[i].get());
+				cupp::copy_device_to_host (&temp[0], source, temp.size(), vector_.stream_.get());
+
+				for (size_type k = 0; k < temp.size(); ++k) {
+					soa_field<T, i>::get(vector_.data_[k]) = temp[k];
+				}
+			}
+		};
+
+		/**
+		 * If there is newer data on the device, this function will update the host data with it.
+		 */
+		void update_host() const {
+			if (!device_changes_) {
+				return;
+			}
+
+			impl::trace_trigger trigger ("host access");
+			impl::trace_scope trace ("update", "soa_vector::update_host");
+
+			if (device_size_ != 0) {
+				field_download download (*this);
+				impl::for_each_soa_field<T>::apply (download);
+			}
+
+			device_changes_ = false;
+		}
+
+		/**
+		 * If there is newer data on the host, this function will update the device data with it.
+		 * Only the changed elements are transfered, unless most of them have been changed.
+		 */
+		void update_device(const device &d) {
+			// the kernel overwrites us, so our data is not needed on the device
+			const bool overwritten = impl::take_access() == write_only;
+			if (overwritten) {
+				host_changes_.clear();
+			}
+
+			// we don't have enough space on the device or we are executed on a new device
+			const bool new_memory = memory_.empty() || capacity_ < data_.size() || d.id() != device_id_;
+
+			if (!new_memory && host_changes_.empty() && device_size_ == data_.size()) {
+				// the kernel reads our arrays in its stream
+				use_in (impl::current_stream());
+				return;
+			}
+
+			impl::trace_scope trace ("update", "soa_vector::update_device");
+
+			// a full upload needs all data on the host
+			const bool full_upload = !overwritten && (new_memory || host_changes_.mostly_dirty(data_.size()));
+			if (full_upload) {
+				update_host();
+			}
+
+			if (new_memory) {
+				// grow geometrically, as long as we stay on the same device
+				size_type capacity = std::max<size_type> (data_.size(), 1);
+				if (!memory_.empty() && d.id() == device_id_) {
+					capacity = std::max (capacity, 2 * capacity_);
+				}
+
+				memory_.assign (fields, shared_device_pointer<char>());
+				capacity_ = capacity;
+
+				field_allocate allocate (*this);
+				impl::for_each_soa_field<T>::apply (allocate);
+			}
+
+			// copy the data to the device, in the stream of the current kernel call
+			stream_ = impl::current_stream();
+			use_in (stream_);
+			uploads_.clear();
+
+			if (full_upload) {
+				upload (0, data_.size());
+			} else {
+				for (impl::dirty_ranges::const_iterator it = host_changes_.begin(); it != host_changes_.end(); ++it) {
+					// elements behind the end may have been removed since they were marked
+					upload (it->first, std::min(it->second, data_.size()));
+				}
+			}
+
+			device_id_ = d.id();
+			device_size_ = data_.size();
+			host_changes_.clear();
+		}
+
+		/**
+		 * Tells the @c caching_allocator that work enqueued in @a s uses the arrays of our fields
+		 */
+		void use_in (const stream &s) const {
+			for (int i = 0; i < fields; ++i) {
+				caching_allocator::instance().use_in_stream (memory_[i].get(), s);
+			}
+		}
+
+		/**
+		 * Transfers the elements [@a begin, @a end) to the device, one copy per field
+		 */
+		void upload(const size_type begin, const size_type end) {
+			if (begin >= end) {
+				return;
+			}
+
+			field_upload upload (*this, begin, end);
+			impl::for_each_soa_field<T>::apply (upload);
+		}
+
+	private:
+		/**
+		 * Our elements, as a std::vector of structs
+		 */
+		mutable std::vector<T> data_;
+
+		/**
+		 * The elements which have been changed on the host, their data on the device is out of date
+		 */
+		mutable impl::dirty_ranges host_changes_;
+
+		/**
+		 * true means, data has been changed on the device and data on the host is out of date
+		 */
+		mutable bool device_changes_;
+
+		/**
+		 * The array of every field on the device
+		 */
+		std::vector< shared_device_pointer<char> > memory_;
+
+		/**
+		 * The number of elements the arrays on the device can store
+		 */
+		size_type capacity_;
+
+		/**
+		 * The number of our elements on the device
+		 */
+		size_type device_size_;
+
+		/**
+		 * The device on which our data is stored
+		 */
+		device::id_t device_id_;
+
+		/**
+		 * The stream our data has been used in the last time on the device
+		 */
+		mutable stream stream_;
+
+		/**
+		 * The pending uploads of our data, keep the staging buffers alive
+		 */
+		std::vector<completion> uploads_;
+};
+
+/**
+ * A soa_vector passed by @c cupp::out() is not transfered to the device
+ */
+template <typename T>
+struct uses_access_mode< soa_vector<T> > {
+	enum { value = true };
+};
+
+} // namespace cupp
+
+#endif
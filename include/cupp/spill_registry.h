@@ -0,0 +1,278 @@
+/*
+ * Copyright: See LICENSE file that comes with this distribution
+ *
+ */
+
+#ifndef CUPP_spill_registry_H
+#define CUPP_spill_registry_H
+
+#if defined(__CUDACC__)
+#error "Not compatible with CUDA. Don't compile with nvcc."
+#endif
+
+// CUPP
+#include "cupp/common.h"
+
+// STD
+#include <cstddef> // Include std::size_t
+#include <list>
+#include <map>
+
+
+namespace cupp {
+
+/**
+ * @class spillable
+ * @platform Host only
+ * @brief The interface of a data structure, whose device memory can be freed by the @c spill_registry and be
+ *        rebuilt from its host data later on.
+ */
+class spillable {
+	public:
+		typedef int id_t;
+
+		virtual ~spillable() {}
+
+		/**
+		 * @brief Frees our memory on the device @a device_id, if its data can be rebuilt from the host data
+		 * @return The number of bytes freed, 0 if the data on the device is newer than on the host
+		 */
+		virtual std::size_t spill (const id_t device_id) = 0;
+};
+
+
+/**
+ * @class spill_registry
+ * @platform Host only
+ * @brief Keeps the data structures with memory on a device in least recently used order, so the
+ *        @c caching_allocator can spill them when the device runs out of memory.
+ *
+ * A data structure is moved to the end of the list of a device by @c touch(), when it is used on the device.
+ * If an allocation fails, @c spill() asks the least recently used data structures to free their memory until enough
+ * bytes have been freed. Data structures touched by the kernel call currently set up are never spilled, as their device
+ * pointers have already been passed to the kernel.
+ *
+ * @warning This class is not thread safe, just like the rest of CuPP.
+ */
+class spill_registry {
+	public:
+		typedef spillable::id_t id_t;
+
+		/**
+		 * @struct statistics
+		 * @brief The spill statistics of one device
+		 */
+		struct statistics {
+			statistics() : spills(0), bytes_spilled(0) {}
+
+			/**
+			 * Number of times a data structure freed its memory
+			 */
+			std::size_t spills;
+
+			/**
+			 * Bytes freed by spilling
+			 */
+			std::size_t bytes_spilled;
+		};
+
+	public: /***  CONSTRUCTORS & DESTRUCTORS  ***/
+		/**
+		 * @return The one and only registry
+		 */
+		static spill_registry& instance() {
+			static spill_registry registry;
+			return registry;
+		}
+
+	public:
+		/**
+		 * @brief Marks @a s as the most recently used data structure on the device @a device_id
+		 */
+		void touch (spillable *s, const id_t device_id);
+
+		/**
+		 * @brief Forgets about @a s on all devices, must be called before @a s is destroyed
+		 */
+		void remove (spillable *s);
+
+		/**
+		 * @brief Spills the least recently used data structures on the device @a device_id, until at least
+		 *        @a size_in_b bytes have been freed or nothing is left to be spilled
+		 * @return The number of bytes freed
+		 */
+		std::size_t spill (const id_t device_id, const std::size_t size_in_b);
+
+		/**
+		 * @brief Called when a kernel call starts to set up its arguments, see @c kernel_impl::launch_scope
+		 */
+		void begin_launch ();
+
+		/**
+		 * @brief Called when a kernel call has been launched
+		 */
+		void end_launch ();
+
+		/**
+		 * @brief Enables or disables spilling
+		 */
+		void set_enabled (const bool enabled) { enabled_ = enabled; }
+
+		/**
+		 * @return true if data structures are spilled when a device runs out of memory
+		 */
+		bool enabled () const { return enabled_; }
+
+		/**
+		 * @return The statistics of the device @a device_id
+		 */
+		statistics stats (const id_t device_id) const;
+
+	private:
+		/**
+		 * @brief A data structure and the kernel call it has been used by last
+		 */
+		struct entry {
+			spillable *s;
+			unsigned long launch;
+		};
+
+		/**
+		 * @brief All data we store per device
+		 */
+		struct device_list {
+			/**
+			 * The least recently used data structure first
+			 */
+			std::list<entry> lru;
+
+			/**
+			 * The position of every data structure in @a lru
+			 */
+			std::map<spillable*, std::list<entry>::iterator> index;
+
+			statistics stats;
+		};
+
+		spill_registry() : enabled_(true), launch_(0), launch_depth_(0) {}
+
+		// not copyable
+		spill_registry (const spill_registry&);
+		spill_registry& operator= (const spill_registry&);
+
+		/**
+		 * @return true if @a e has been touched by the kernel call currently set up
+		 */
+		bool pinned (const entry &e) const { return launch_depth_ != 0 && e.launch == launch_; }
+
+	private:
+		/**
+		 * true means data structures are spilled
+		 */
+		bool enabled_;
+
+		/**
+		 * The number of the current (or last) kernel call
+		 */
+		unsigned long launch_;
+
+		/**
+		 * The number of kernel calls currently set up, a kernel call may be started while another one is set up
+		 */
+		int launch_depth_;
+
+		/**
+		 * Our lists, one per device
+		 */
+		std::map<id_t, device_list> devices_;
+};
+
+
+inline void spill_registry::touch (spillable *s, const id_t device_id) {
+	device_list &list = devices_[device_id];
+
+	std::map<spillable*, std::list<entry>::iterator>::iterator it = list.index.find(s);
+	if (it != list.index.end()) {
+		list.lru.erase(it->second);
+	}
+
+	entry e;
+	e.s      = s;
+	e.launch = launch_;
+	list.index[s] = list.lru.insert(list.lru.end(), e);
+}
+
+
+inline void spill_registry::remove (spillable *s) {
+	for (std::map<id_t, device_list>::iterator d = devices_.begin(); d != devices_.end(); ++d) {
+		std::map<spillable*, std::list<entry>::iterator>::iterator it = d->second.index.find(s);
+		if (it != d->second.index.end()) {
+			d->second.lru.erase(it->second);
+			d->second.index.erase(it);
+		}
+	}
+}
+
+
+inline std::size_t spill_registry::spill (const id_t device_id, const std::size_t size_in_b) {
+	std::size_t freed = 0;
+
+	if (!enabled_) {
+		return freed;
+	}
+
+	std::map<id_t, device_list>::iterator d = devices_.find(device_id);
+	if (d == devices_.end()) {
+		return freed;
+	}
+	device_list &list = d->second;
+
+	for (std::list<entry>::iterator it = list.lru.begin(); it != list.lru.end() && freed < size_in_b; ) {
+		if (pinned(*it)) {
+			++it;
+			continue;
+		}
+
+		const std::size_t bytes = it->s->spill(device_id);
+		if (bytes == 0) {
+			// its data on the device is newer than on the host, maybe it can be spilled next time
+			++it;
+			continue;
+		}
+
+		freed += bytes;
+		++list.stats.spills;
+		list.stats.bytes_spilled += bytes;
+
+		list.index.erase(it->s);
+		it = list.lru.erase(it);
+	}
+
+	return freed;
+}
+
+
+inline void spill_registry::begin_launch () {
+	if (launch_depth_ == 0) {
+		++launch_;
+	}
+	++launch_depth_;
+}
+
+
+inline void spill_registry::end_launch () {
+	--launch_depth_;
+}
+
+
+inline spill_registry::statistics spill_registry::stats (const id_t device_id) const {
+	std::map<id_t, device_list>::const_iterator it = devices_.find(device_id);
+	if (it == devices_.end()) {
+		return statistics();
+	}
+	return it->second.stats;
+}
+
+} // namespace cupp
+
+#endif
@@ -0,0 +1,619 @@
+/*
+ * Copyright: See LICENSE file that comes with this distribution
+ *
+ */
+
+#ifndef CUPP_staging_pool_H
+#define CUPP_staging_pool_H
+
+#if defined(__CUDACC__)
+#error "Not compatible with CUDA. Don't compile with nvcc."
+#endif
+
+// CUPP
+#include "cupp/common.h"
+#include "cupp/exception/cuda_runtime_error.h"
+
+// STD
+#include <cstddef> // Include std::size_t
+#include <cstring> // Include std::memcpy
+#include <algorithm> // Include std::min
+#include <map>
+#include <utility> // Include std::make_pair
+#include <vector>
+
+// CUDA
+#include <cuda_runtime.h>
+
+
+namespace cupp {
+
+/**
+ * @class staging_pool
+ * @platform Host only
+ * @brief A pool of page-locked host buffers used to stage transfers between pageable host memory and the device.
+ *
+ * Transfers of at least @c threshold() bytes are split into chunks of @c chunk_size() bytes. Two chunks are used
+ * in turns, so the host side memcpy into (or out of) one chunk overlaps with the DMA transfer of the other one.
+ * At most @c pool_size() idle chunks are kept, everything above is returned to the driver.
+ * Requests of at most @c small_buffer_size bytes (e.g. the write-back of a single value) are served from a separate
+ * list of small buffers, so they don't occupy a whole chunk.
+ * Requests bigger than a chunk (e.g. a big asynchronous copy) get a buffer of a power of two multiple of
+ * @c chunk_size(). Those are kept as well, up to @c max_large_bytes() in total, as cudaHostAlloc and cudaFreeHost
+ * synchronize the whole device.
+ * Every buffer remembers its size and the device it has been allocated on, so a buffer is given back to the right
+ * list even if the chunk size has been changed while it was in use, and the buffers die with the context of their device
+ * (see @c device_reset()).
+ *
+ * @warning This class is not thread safe, just like the rest of CuPP.
+ */
+class staging_pool {
+	public:
+		/**
+		 * @brief The size of the small buffers in bytes
+		 */
+		static const std::size_t small_buffer_size = 4096;
+
+		/**
+		 * @brief The maximum number of idle small buffers kept by the pool
+		 */
+		static const std::size_t small_pool_size = 64;
+
+		/**
+		 * @struct statistics
+		 * @brief Counts the bytes moved through the pinned and the pageable path
+		 */
+		struct statistics {
+			statistics() : pinned_bytes_to_device(0), pinned_bytes_to_host(0), pageable_bytes_to_device(0), pageable_bytes_to_host(0), pinned_transfers(0), chunks_allocated(0) {}
+
+			/**
+			 * Bytes copied host -> device through a staging buffer
+			 */
+			std::size_t pinned_bytes_to_device;
+
+			/**
+			 * Bytes copied device -> host through a staging buffer
+			 */
+			std::size_t pinned_bytes_to_host;
+
+			/**
+			 * Bytes copied host -> device directly from pageable memory
+			 */
+			std::size_t pageable_bytes_to_device;
+
+			/**
+			 * Bytes copied device -> host directly to pageable memory
+			 */
+			std::size_t pageable_bytes_to_host;
+
+			/**
+			 * Number of transfers that went through the staging buffers
+			 */
+			std::size_t pinned_transfers;
+
+			/**
+			 * Number of calls to cudaHostAlloc
+			 */
+			std::size_t chunks_allocated;
+		};
+
+	public: /***  CONSTRUCTORS & DESTRUCTORS  ***/
+		/**
+		 * @return The one and only staging pool
+		 */
+		static staging_pool& instance() {
+			static staging_pool pool;
+			return pool;
+		}
+
+		/**
+		 * @brief Frees all idle buffers, errors are ignored as the driver may already be shut down
+		 */
+		~staging_pool();
+
+	public: /***  CONFIGURATION  ***/
+		/**
+		 * @brief Sets the size of one staging chunk in bytes, all idle chunks are freed.
+		 *        Chunks in use are freed when they are given back.
+		 * @exception cuda_runtime_error if @a chunk_size is not bigger than @c small_buffer_size
+		 */
+		void set_chunk_size (const std::size_t chunk_size);
+
+		/**
+		 * @return The size of one staging chunk in bytes
+		 */
+		std::size_t chunk_size () const { return chunk_size_; }
+
+		/**
+		 * @brief Sets the maximum number of idle chunks kept by the pool
+		 */
+		void set_pool_size (const std::size_t pool_size);
+
+		/**
+		 * @return The maximum number of idle chunks kept by the pool
+		 */
+		std::size_t pool_size () const { return pool_size_; }
+
+		/**
+		 * @brief Transfers smaller than @a threshold bytes are not staged
+		 */
+		void set_threshold (const std::size_t threshold) { threshold_ = threshold; }
+
+		/**
+		 * @return The minimal size in bytes of a staged transfer
+		 */
+		std::size_t threshold () const { return threshold_; }
+
+		/**
+		 * @brief Sets the maximum number of bytes kept in idle buffers bigger than a chunk
+		 */
+		void set_max_large_bytes (const std::size_t max_large_bytes);
+
+		/**
+		 * @return The maximum number of bytes kept in idle buffers bigger than a chunk
+		 */
+		std::size_t max_large_bytes () const { return max_large_bytes_; }
+
+	public:
+		/**
+		 * @brief Copies @a size_in_b bytes from host memory @a source to device memory @a destination
+		 * @exception cuda_runtime_error
+		 */
+		void copy_host_to_device (void* destination, const void* source, const std::size_t size_in_b);
+
+		/**
+		 * @brief Copies @a size_in_b bytes from device memory @a source to host memory @a destination in @a stream,
+		 *        returns when the data has arrived. Only @a stream is waited for.
+		 * @exception cuda_runtime_error
+		 */
+		void copy_device_to_host (void* destination, const void* source, const std::size_t size_in_b, cudaStream_t stream = 0);
+
+		/**
+		 * @return A page-locked buffer of at least @a size_in_b bytes
+		 * @note Requests bigger than @c chunk_size() get a buffer of a power of two multiple of @c chunk_size(),
+		 *       requests of at most @c small_buffer_size bytes get a small buffer.
+		 * @exception cuda_runtime_error
+		 */
+		void* acquire (const std::size_t size_in_b);
+
+		/**
+		 * @brief Gives @a buffer returned by @c acquire() back to the pool
+		 * @exception cuda_runtime_error
+		 */
+		void release (void* buffer);
+
+		/**
+		 * @brief Frees all idle chunks, small and large buffers
+		 * @exception cuda_runtime_error
+		 */
+		void release ();
+
+		/**
+		 * @brief Frees all idle buffers allocated on the device @a device_id and forgets about its buffers still in use
+		 * @note Must be called before the context of the device is destroyed, as the buffers die with it.
+		 */
+		void device_reset (const int device_id);
+
+		/**
+		 * @return The transfer statistics
+		 */
+		const statistics& stats () const { return stats_; }
+
+		/**
+		 * @brief Resets the transfer statistics
+		 */
+		void reset_stats () { const std::size_t chunks = stats_.chunks_allocated; stats_ = statistics(); stats_.chunks_allocated = chunks; }
+
+		/**
+		 * @brief Used by the cupp::copy_* functions to count transfers not passed through the pool
+		 */
+		void count_pageable (const std::size_t to_device, const std::size_t to_host) {
+			stats_.pageable_bytes_to_device += to_device;
+			stats_.pageable_bytes_to_host   += to_host;
+		}
+
+		/**
+		 * @brief Used by the cupp::copy_*_async functions to count transfers staged in a buffer from @c acquire()
+		 */
+		void count_pinned (const std::size_t to_device, const std::size_t to_host) {
+			stats_.pinned_bytes_to_device += to_device;
+			stats_.pinned_bytes_to_host   += to_host;
+			++stats_.pinned_transfers;
+		}
+
+	private:
+		staging_pool() : chunk_size_(1 << 20), pool_size_(4), threshold_(1 << 18), max_large_bytes_(std::size_t(1) << 28), large_idle_bytes_(0) {}
+
+		// not copyable
+		staging_pool (const staging_pool&);
+		staging_pool& operator= (const staging_pool&);
+
+		/**
+		 * @brief A buffer allocated by us
+		 */
+		struct buffer_info {
+			std::size_t size;
+			int device_id;
+		};
+
+		/**
+		 * @brief Waits for @a event and destroys it
+		 */
+		static void wait_and_destroy (cudaEvent_t &event);
+
+		/**
+		 * @return A new page-locked buffer of @a size bytes
+		 * @exception cuda_runtime_error
+		 */
+		void* allocate (const std::size_t size);
+
+		/**
+		 * @brief Returns @a buffer to the driver
+		 * @exception cuda_runtime_error
+		 */
+		void free_buffer (void* buffer);
+
+		/**
+		 * @return The size of the buffer allocated for a request of @a size_in_b bytes bigger than a chunk
+		 */
+		std::size_t large_size (const std::size_t size_in_b) const;
+
+		/**
+		 * @brief Frees the biggest idle large buffers until at most @a max_bytes are kept
+		 */
+		void trim_large (const std::size_t max_bytes);
+
+	private:
+		/**
+		 * The size of one chunk
+		 */
+		std::size_t chunk_size_;
+
+		/**
+		 * How many idle chunks we keep
+		 */
+		std::size_t pool_size_;
+
+		/**
+		 * Smaller transfers are not staged
+		 */
+		std::size_t threshold_;
+
+		/**
+		 * Our idle chunks
+		 */
+		std::vector<void*> idle_;
+
+		/**
+		 * Our idle small buffers
+		 */
+		std::vector<void*> small_idle_;
+
+		/**
+		 * How many bytes we keep in idle large buffers
+		 */
+		std::size_t max_large_bytes_;
+
+		/**
+		 * Our idle large buffers by their size
+		 */
+		std::multimap<std::size_t, void*> large_idle_;
+
+		/**
+		 * The bytes in @a large_idle_
+		 */
+		std::size_t large_idle_bytes_;
+
+		/**
+		 * All buffers allocated by us and not freed yet, idle or in use
+		 */
+		std::map<void*, buffer_info> buffers_;
+
+		statistics stats_;
+};
+
+
+inline staging_pool::~staging_pool() {
+	for (std::size_t i = 0; i < idle_.size(); ++i) {
+		cudaFreeHost (idle_[i]);
+	}
+	for (std::size_t i = 0; i < small_idle_.size(); ++i) {
+		cudaFreeHost (small_idle_[i]);
+	}
+	for (std::multimap<std::size_t, void*>::iterator it = large_idle_.begin(); it != large_idle_.end(); ++it) {
+		cudaFreeHost (it->second);
+	}
+}
+
+
+inline void staging_pool::set_chunk_size (const std::size_t chunk_size) {
+	if (chunk_size <= small_buffer_size) {
+		throw exception::cuda_runtime_error(cudaErrorInvalidValue);
+	}
+
+	release();
+	chunk_size_ = chunk_size;
+}
+
+
+inline void staging_pool::set_pool_size (const std::size_t pool_size) {
+	pool_size_ = pool_size;
+
+	while (idle_.size() > pool_size_) {
+		free_buffer (idle_.back());
+		idle_.pop_back();
+	}
+}
+
+
+inline void staging_pool::set_max_large_bytes (const std::size_t max_large_bytes) {
+	max_large_bytes_ = max_large_bytes;
+	trim_large (max_large_bytes_);
+}
+
+
+inline std::size_t staging_pool::large_size (const std::size_t size_in_b) const {
+	std::size_t size = chunk_size_;
+	while (size < size_in_b) {
+		size <<= 1;
+	}
+	return size;
+}
+
+
+inline void staging_pool::trim_large (const std::size_t max_bytes) {
+	while (large_idle_bytes_ > max_bytes) {
+		std::multimap<std::size_t, void*>::iterator biggest = large_idle_.end();
+		--biggest;
+
+		free_buffer (biggest->second);
+		large_idle_bytes_ -= biggest->first;
+		large_idle_.erase(biggest);
+	}
+}
+
+
+inline void* staging_pool::acquire (const std::size_t size_in_b) {
+	if (size_in_b <= small_buffer_size) {
+		if (!small_idle_.empty()) {
+			void* returnee = small_idle_.back();
+			small_idle_.pop_back();
+			return returnee;
+		}
+
+		return allocate (small_buffer_size);
+	}
+
+	if (size_in_b <= chunk_size_ && !idle_.empty()) {
+		void* returnee = idle_.back();
+		idle_.pop_back();
+		return returnee;
+	}
+
+	const std::size_t size = size_in_b <= chunk_size_ ? chunk_size_ : large_size(size_in_b);
+
+	if (size_in_b > chunk_size_) {
+		std::multimap<std::size_t, void*>::iterator it = large_idle_.find(size);
+		if (it != large_idle_.end()) {
+			void* returnee = it->second;
+			large_idle_bytes_ -= size;
+			large_idle_.erase(it);
+			return returnee;
+		}
+	}
+
+	void* returnee = allocate (size);
+	++stats_.chunks_allocated;
+
+	return returnee;
+}
+
+
+inline void* staging_pool::allocate (const std::size_t size) {
+	int device_id = 0;
+	void* returnee;
+	if (cudaGetDevice (&device_id) != cudaSuccess || cudaHostAlloc (&returnee, size, cudaHostAllocPortable) != cudaSuccess) {
+		throw exception::cuda_runtime_error(cudaGetLastError());
+	}
+
+	buffer_info info;
+	info.size      = size;
+	info.device_id = device_id;
+	buffers_[returnee] = info;
+
+	return returnee;
+}
+
+
+inline void staging_pool::free_buffer (void* buffer) {
+	buffers_.erase(buffer);
+	if (cudaFreeHost(buffer) != cudaSuccess) {
+		throw exception::cuda_runtime_error(cudaGetLastError());
+	}
+}
+
+
+inline void staging_pool::release (void* buffer) {
+	const std::map<void*, buffer_info>::const_iterator it = buffers_.find(buffer);
+	if (it == buffers_.end()) {
+		// allocated on a device which has been reset since, the buffer is gone with its context
+		return;
+	}
+
+	// sorted by the size allocated, the chunk size may have been changed in the meantime
+	const std::size_t size = it->second.size;
+
+	if (size == small_buffer_size && small_idle_.size() < small_pool_size) {
+		small_idle_.push_back(buffer);
+		return;
+	}
+
+	if (size == chunk_size_ && idle_.size() < pool_size_) {
+		idle_.push_back(buffer);
+		return;
+	}
+
+	if (size > chunk_size_ && size <= max_large_bytes_) {
+		// make room by freeing the biggest idle buffers first
+		trim_large (max_large_bytes_ - size);
+		large_idle_.insert(std::make_pair(size, buffer));
+		large_idle_bytes_ += size;
+		return;
+	}
+
+	free_buffer (buffer);
+}
+
+
+inline void staging_pool::release () {
+	const std::size_t pool_size = pool_size_;
+	set_pool_size (0);
+	pool_size_ = pool_size;
+
+	while (!small_idle_.empty()) {
+		free_buffer (small_idle_.back());
+		small_idle_.pop_back();
+	}
+
+	trim_large (0);
+}
+
+
+inline void staging_pool::device_reset (const int device_id) {
+	// the device may already be in a bad state, so errors are ignored
+	std::vector<void*>* lists[2] = { &idle_, &small_idle_ };
+	for (int l = 0; l < 2; ++l) {
+		std::vector<void*> &list = *lists[l];
+		for (std::size_t i = 0; i < list.size(); ) {
+			if (buffers_[list[i]].device_id == device_id) {
+				cudaFreeHost (list[i]);
+				list[i] = list.back();
+				list.pop_back();
+			} else {
+				++i;
+			}
+		}
+	}
+
+	for (std::multimap<std::size_t, void*>::iterator it = large_idle_.begin(); it != large_idle_.end(); ) {
+		if (buffers_[it->second].device_id == device_id) {
+			cudaFreeHost (it->second);
+			large_idle_bytes_ -= it->first;
+			large_idle_.erase(it++);
+		} else {
+			++it;
+		}
+	}
+
+	for (std::map<void*, buffer_info>::iterator it = buffers_.begin(); it != buffers_.end(); ) {
+		if (it->second.device_id == device_id) {
+			buffers_.erase(it++);
+		} else {
+			++it;
+		}
+	}
+}
+
+
+inline void staging_pool::wait_and_destroy (cudaEvent_t &event) {
+	if (event == 0) {
+		return;
+	}
+	const cudaError_t error = cudaEventSynchronize (event);
+	cudaEventDestroy (event);
+	event = 0;
+
+	if (error != cudaSuccess) {
+		throw exception::cuda_runtime_error(cudaGetLastError());
+	}
+}
+
+
+inline void staging_pool::copy_host_to_device (void* destination, const void* source, const std::size_t size_in_b) {
+	char*       dst = static_cast<char*>(destination);
+	const char* src = static_cast<const char*>(source);
+
+	void*       chunk[2] = { acquire(chunk_size_), acquire(chunk_size_) };
+	cudaEvent_t done[2]  = { 0, 0 };
+
+	try {
+		for (std::size_t offset = 0, i = 0; offset < size_in_b; offset += chunk_size_, i ^= 1) {
+			const std::size_t count = std::min(chunk_size_, size_in_b - offset);
+
+			// the last DMA out of this chunk must be finished, before we overwrite it
+			wait_and_destroy (done[i]);
+
+			std::memcpy (chunk[i], src + offset, count);
+
+			if (cudaMemcpyAsync (dst + offset, chunk[i], count, cudaMemcpyHostToDevice, 0) != cudaSuccess ||
+			    cudaEventCreate (&done[i]) != cudaSuccess ||
+			    cudaEventRecord (done[i], 0) != cudaSuccess) {
+				throw exception::cuda_runtime_error(cudaGetLastError());
+			}
+		}
+
+		wait_and_destroy (done[0]);
+		wait_and_destroy (done[1]);
+	} catch (...) {
+		if (done[0] != 0) cudaEventDestroy (done[0]);
+		if (done[1] != 0) cudaEventDestroy (done[1]);
+		cudaThreadSynchronize();
+		release (chunk[0]);
+		release (chunk[1]);
+		throw;
+	}
+
+	release (chunk[0]);
+	release (chunk[1]);
+
+	stats_.pinned_bytes_to_device += size_in_b;
+	++stats_.pinned_transfers;
+}
+
+
+inline void staging_pool::copy_device_to_host (void* destination, const void* source, const std::size_t size_in_b, cudaStream_t stream) {
+	char*       dst = static_cast<char*>(destination);
+	const char* src = static_cast<const char*>(source);
+
+	void*       chunk[2] = { acquire(chunk_size_), acquire(chunk_size_) };
+	cudaEvent_t done[2]  = { 0, 0 };
+	std::size_t chunk_offset[2] = { 0, 0 };
+
+	try {
+		// we always have up to two DMA transfers in flight, the host copies out of the older one
+		for (std::size_t offset = 0, i = 0; offset < size_in_b + 2*chunk_size_; offset += chunk_size_, i ^= 1) {
+			if (done[i] != 0) {
+				wait_and_destroy (done[i]);
+				std::memcpy (dst + chunk_offset[i], chunk[i], std::min(chunk_size_, size_in_b - chunk_offset[i]));
+			}
+
+			if (offset < size_in_b) {
+				const std::size_t count = std::min(chunk_size_, size_in_b - offset);
+				chunk_offset[i] = offset;
+
+				if (cudaMemcpyAsync (chunk[i], src + offset, count, cudaMemcpyDeviceToHost, stream) != cudaSuccess ||
+				    cudaEventCreate (&done[i]) != cudaSuccess ||
+				    cudaEventRecord (done[i], stream) != cudaSuccess) {
+					throw exception::cuda_runtime_error(cudaGetLastError());
+				}
+			}
+		}
+	} catch (...) {
+		if (done[0] != 0) cudaEventDestroy (done[0]);
+		if (done[1] != 0) cudaEventDestroy (done[1]);
+		cudaThreadSynchronize();
+		release (chunk[0]);
+		release (chunk[1]);
+		throw;
+	}
+
+	release (chunk[0]);
+	release (chunk[1]);
+
+	stats_.pinned_bytes_to_host += size_in_b;
+	++stats_.pinned_transfers;
+}
+
+} // namespace cupp
+
+#endif
@@ -0,0 +1,219 @@
+/*
+ * Copyright: See LICENSE file that comes with this distribution
+ *
+ */
+
+#ifndef CUPP_stream_H
+#define CUPP_stream_H
+
+#if defined(__CUDACC__)
+#error "Not compatible with CUDA. Don't compile with nvcc."
+#endif
+
+// CUPP
+#include "cupp/common.h"
+#include "cupp/exception/cuda_runtime_error.h"
+
+// BOOST
+#include <boost/shared_ptr.hpp>
+
+// CUDA
+#include <cuda_runtime.h>
+
+
+namespace cupp {
+
+// Just used to force the user to configure and get a device.
+class device;
+
+/**
+ * @class stream
+ * @platform Host only
+ * @brief Represents a CUDA stream. Work enqueued in different streams may run concurrently on one device.
+ *
+ * A stream can be passed to @c cupp::kernel::operator() and to the asynchronous copy functions.
+ * It is implicitly convertible to @c cudaStream_t.
+ * Copies of a stream share the same CUDA stream, which is destroyed together with the last copy.
+ * Data structures passed to a kernel keep a copy of the stream of the kernel call, so their later transfers
+ * can be ordered behind the kernel.
+ */
+class stream {
+	public:
+		/**
+		 * @brief Represents the default stream (stream 0)
+		 */
+		stream() {}
+
+		// dev is a pure dummy, it is only used to force the user to configure a device
+		// before creating a stream on it.
+		/**
+		 * @brief Creates a new stream on the device @a dev
+		 * @exception cuda_runtime_error
+		 */
+		explicit stream (device const& dev) {
+			(void)dev;
+
+			cudaStream_t temp;
+			if (cudaStreamCreate(&temp) != cudaSuccess) {
+				throw exception::cuda_runtime_error(cudaGetLastError());
+			}
+			stream_.reset(temp, &stream::destroy);
+		}
+
+		/**
+		 * @brief Wraps the CUDA stream @a s, which is not destroyed by @a this
+		 */
+		explicit stream (cudaStream_t s) : stream_(s, &stream::do_not_destroy) {}
+
+		/**
+		 * @brief Blocks until all work enqueued in @a this has been completed
+		 * @exception cuda_runtime_error
+		 */
+		void sync() const {
+			if (cudaStreamSynchronize(get()) != cudaSuccess) {
+				throw exception::cuda_runtime_error(cudaGetLastError());
+			}
+		}
+
+		/**
+		 * @return true if all work enqueued in @a this has been completed
+		 * @exception cuda_runtime_error
+		 */
+		bool query() const {
+			const cudaError_t error = cudaStreamQuery(get());
+			if (error == cudaSuccess) {
+				return true;
+			}
+			if (error != cudaErrorNotReady) {
+				throw exception::cuda_runtime_error(error);
+			}
+			return false;
+		}
+
+		/**
+		 * @return The CUDA stream handled by @a this
+		 */
+		cudaStream_t get() const { return stream_.get(); }
+
+		/**
+		 * @return The CUDA stream handled by @a this
+		 */
+		operator cudaStream_t() const { return get(); }
+
+	private:
+		static void destroy (cudaStream_t s) {
+			// already enqueued work is still finished by the device
+			cudaStreamDestroy(s);
+		}
+
+		static void do_not_destroy (cudaStream_t s) {
+			UNUSED_PARAMETER(s);
+		}
+
+	private:
+		/**
+		 * Our CUDA stream, an empty pointer is the default stream
+		 */
+		boost::shared_ptr<CUstream_st> stream_;
+}; // class stream
+
+
+namespace impl {
+
+/**
+ * @return The stream the current kernel call enqueues its work in. Used by the data structures to put their transfers
+ *         into the same stream as the kernel they are passed to.
+ */
+inline stream& current_stream() {
+	static stream current;
+	return current;
+}
+
+/**
+ * @class stream_guard
+ * @brief Sets @c current_stream() for its lifetime
+ */
+class stream_guard {
+	public:
+		explicit stream_guard (const stream &s) : old_(current_stream()) {
+			current_stream() = s;
+		}
+
+		~stream_guard() {
+			current_stream() = old_;
+		}
+
+	private:
+		stream old_;
+};
+
+/**
+ * @brief Makes the work enqueued in @a s afterwards wait for all work enqueued in @a other up to now,
+ *        without blocking the host
+ * @exception cuda_runtime_error
+ */
+inline void wait_for_stream (const stream &s, const cudaStream_t other) {
+	if (s.get() == 0 || other == 0 || s.get() == other) {
+		// the default stream waits for all other streams on its own and they wait for the work enqueued in it before
+		return;
+	}
+
+	cudaEvent_t event;
+	if (cudaEventCreateWithFlags(&event, cudaEventDisableTiming) != cudaSuccess) {
+		throw exception::cuda_runtime_error(cudaGetLastError());
+	}
+
+	const bool failed = cudaEventRecord(event, other) != cudaSuccess || cudaStreamWaitEvent(s.get(), event, 0) != cudaSuccess;
+
+	// the event is released by the driver once it has completed
+	cudaEventDestroy(event);
+
+	if (failed) {
+		throw exception::cuda_runtime_error(cudaGetLastError());
+	}
+}
+
+/**
+ * @brief Makes the work enqueued in @a s on the current device afterwards wait for all work enqueued in @a other
+ *        on the device @a other_device up to now, without blocking the host. The default streams of two devices
+ *        do not wait for each other, so the event is recorded even if one of the streams is the default stream.
+ * @exception cuda_runtime_error
+ */
+inline void wait_for_stream (const stream &s, const cudaStream_t other, const int other_device) {
+	int cur_device = 0;
+	cudaGetDevice (&cur_device);
+	if (cur_device == other_device) {
+		wait_for_stream (s, other);
+		return;
+	}
+
+	// the event must be recorded on the device of its stream
+	cudaSetDevice (other_device);
+
+	cudaEvent_t event = 0;
+	cudaError_t error = cudaEventCreateWithFlags(&event, cudaEventDisableTiming);
+	if (error == cudaSuccess) {
+		error = cudaEventRecord(event, other);
+	}
+
+	cudaSetDevice (cur_device);
+
+	if (error == cudaSuccess) {
+		error = cudaStreamWaitEvent(s.get(), event, 0);
+	}
+
+	if (event != 0) {
+		// the event is released by the driver once it has completed
+		cudaEventDestroy(event);
+	}
+
+	if (error != cudaSuccess) {
+		throw exception::cuda_runtime_error(error);
+	}
+}
+
+} // namespace impl
+
+} // namespace cupp
+
+#endif
@@ -0,0 +1,281 @@
+/*
+ * Copyright: See LICENSE file that comes with this distribution
+ *
+ */
+
+#ifndef CUPP_tracer_H
+#define CUPP_tracer_H
+
+#if defined(__CUDACC__)
+#error "Not compatible with CUDA. Don't compile with nvcc."
+#endif
+
+// CUPP
+#include "cupp/common.h"
+
+// STD
+#include <cstddef> // Include std::size_t
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// BOOST
+#include <boost/cstdint.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+
+
+namespace cupp {
+
+/**
+ * @class tracer
+ * @platform Host only
+ * @brief Records the transfers, the updates of the data structures and the kernel launches done by CuPP,
+ *        and writes them as Chrome trace events (load the file in chrome://tracing or Perfetto).
+ *
+ * Tracing is disabled by default and costs a single test per event then. Every event carries the time it started and
+ * how long it took on the host, the number of bytes transfered and what triggered it, e.g. "kernel argument" for an
+ * update of a vector passed to a kernel or "iterator" for an update caused by dereferencing an iterator.
+ * For asynchronous transfers and kernel launches only the time needed to enqueue them is recorded.
+ *
+ * @example tracer::instance().enable(); ...; tracer::instance().save("cupp_trace.json");
+ * @warning This class is not thread safe, just like the rest of CuPP.
+ */
+class tracer {
+	public:
+		/**
+		 * @struct event
+		 * @brief One recorded event
+		 */
+		struct event {
+			/**
+			 * What happend, e.g. "copy_host_to_device"
+			 */
+			const char* name;
+
+			/**
+			 * The kind of event: "transfer", "update" or "kernel"
+			 */
+			const char* category;
+
+			/**
+			 * What caused the event, 0 if unknown
+			 */
+			const char* trigger;
+
+			/**
+			 * Microseconds since tracing has been enabled
+			 */
+			boost::int64_t begin;
+
+			/**
+			 * Duration on the host in microseconds
+			 */
+			boost::int64_t duration;
+
+			/**
+			 * Number of bytes transfered, 0 if nothing is transfered
+			 */
+			std::size_t bytes;
+		};
+
+	public: /***  CONSTRUCTORS & DESTRUCTORS  ***/
+		/**
+		 * @return The one and only tracer
+		 */
+		static tracer& instance() {
+			static tracer t;
+			return t;
+		}
+
+	public:
+		/**
+		 * @brief Starts recording, the time stamps are relative to the first call
+		 */
+		void enable();
+
+		/**
+		 * @brief Stops recording, the events recorded so far are kept
+		 */
+		void disable() { enabled_ = false; }
+
+		/**
+		 * @return true if events are recorded
+		 */
+		bool enabled() const { return enabled_; }
+
+		/**
+		 * @brief Forgets all events recorded so far
+		 */
+		void clear() { events_.clear(); }
+
+		/**
+		 * @return All events recorded so far
+		 */
+		const std::vector<event>& events() const { return events_; }
+
+		/**
+		 * @return Microseconds since tracing has been enabled
+		 */
+		boost::int64_t now() const;
+
+		/**
+		 * @brief Records an event
+		 */
+		void record (const event &e) { events_.push_back(e); }
+
+		/**
+		 * @brief Writes all events as Chrome trace-event JSON to @a out
+		 */
+		void write (std::ostream &out) const;
+
+		/**
+		 * @brief Writes all events as Chrome trace-event JSON into the file @a filename
+		 * @return false if the file could not be written
+		 */
+		bool save (const std::string &filename) const;
+
+	private:
+		tracer() : enabled_(false), started_(false) {}
+
+		// not copyable
+		tracer (const tracer&);
+		tracer& operator= (const tracer&);
+
+	private:
+		/**
+		 * true means events are recorded
+		 */
+		bool enabled_;
+
+		/**
+		 * true if @a start_ has been set
+		 */
+		bool started_;
+
+		/**
+		 * The time of the first call to @c enable()
+		 */
+		boost::posix_time::ptime start_;
+
+		/**
+		 * The recorded events
+		 */
+		std::vector<event> events_;
+};
+
+
+inline void tracer::enable() {
+	if (!started_) {
+		start_ = boost::posix_time::microsec_clock::universal_time();
+		started_ = true;
+	}
+	enabled_ = true;
+}
+
+
+inline boost::int64_t tracer::now() const {
+	return (boost::posix_time::microsec_clock::universal_time() - start_).total_microseconds();
+}
+
+
+inline void tracer::write (std::ostream &out) const {
+	out << "{\"traceEvents\":[";
+
+	for (std::vector<event>::const_iterator it = events_.begin(); it != events_.end(); ++it) {
+		if (it != events_.begin()) {
+			out << ",";
+		}
+
+		out << "\n{\"name\":\"" << it->name << "\",\"cat\":\"" << it->category << "\",\"ph\":\"X\",\"pid\":0,\"tid\":0"
+		    << ",\"ts\":" << it->begin << ",\"dur\":" << it->duration << ",\"args\":{";
+
+		// the updates and launches transfer nothing themselves, their transfers are events of their own
+		if (it->bytes != 0) {
+			out << "\"bytes\":" << it->bytes << (it->trigger != 0 ? "," : "");
+		}
+		if (it->trigger != 0) {
+			out << "\"trigger\":\"" << it->trigger << "\"";
+		}
+
+		out << "}}";
+	}
+
+	out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+
+inline bool tracer::save (const std::string &filename) const {
+	std::ofstream out (filename.c_str());
+	write (out);
+	return !out.fail();
+}
+
+
+namespace impl {
+
+/**
+ * @return What causes the current transfers, 0 if unknown. Recorded by the @c tracer.
+ */
+inline const char*& current_trace_trigger() {
+	static const char* current = 0;
+	return current;
+}
+
+/**
+ * @class trace_trigger
+ * @brief Sets @c current_trace_trigger() for its lifetime. The outermost trigger wins, e.g. a comparison of two
+ *        vectors is recorded as "comparison" and not as the host access it is implemented with.
+ *        Does nothing if the @c tracer is disabled.
+ */
+class trace_trigger {
+	public:
+		explicit trace_trigger (const char* trigger) : set_(tracer::instance().enabled() && current_trace_trigger() == 0) {
+			if (set_) {
+				current_trace_trigger() = trigger;
+			}
+		}
+
+		~trace_trigger() {
+			if (set_) {
+				current_trace_trigger() = 0;
+			}
+		}
+
+	private:
+		const bool set_;
+};
+
+/**
+ * @class trace_scope
+ * @brief Records an event lasting for its lifetime, if the @c tracer is enabled
+ */
+class trace_scope {
+	public:
+		trace_scope (const char* category, const char* name, const std::size_t bytes = 0) : enabled_(tracer::instance().enabled()) {
+			if (enabled_) {
+				event_.name     = name;
+				event_.category = category;
+				event_.trigger  = current_trace_trigger();
+				event_.bytes    = bytes;
+				event_.begin    = tracer::instance().now();
+			}
+		}
+
+		~trace_scope() {
+			if (enabled_) {
+				event_.duration = tracer::instance().now() - event_.begin;
+				tracer::instance().record (event_);
+			}
+		}
+
+	private:
+		const bool enabled_;
+		tracer::event event_;
+};
+
+} // namespace impl
+
+} // namespace cupp
+
+#endif
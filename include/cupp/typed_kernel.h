@@ -0,0 +1,1336 @@
+/*
+ * Copyright: See LICENSE file that comes with this distribution
+ *
+ */
+
+#ifndef CUPP_typed_kernel_H
+#define CUPP_typed_kernel_H
+
+#if defined(__CUDACC__)
+#error "Not compatible with CUDA. Don't compile with nvcc."
+#endif
+
+
+// CUPP
+#include "cupp/common.h"
+#include "cupp/kernel_impl/argument_stack.h"
+#include "cupp/kernel_impl/static_argument.h"
+#include "cupp/kernel_type_binding.h"
+#include "cupp/kernel_call_traits.h"
+#include "cupp/device.h"
+#include "cupp/stream.h"
+#include "cupp/kernel_impl/launch_arena.h"
+
+// BOOST
+#include <boost/type_traits.hpp>
+#include <boost/static_assert.hpp>
+
+// CUDA
+#include <vector_types.h>
+#include <cuda_runtime.h>
+
+
+namespace cupp {
+
+/**
+ * @class typed_kernel
+ * @platform Host only!
+ * @brief Represents a __global__ function, just like @c cupp::kernel, but the arguments are mapped to the parameters
+ *        of the __global__ function at compile time.
+ *
+ * A call builds no argument list on the heap, uses no boost::any and no virtual function. The device references
+ * of arguments passed by reference still allocate their reference counts. Passing an argument
+ * of the wrong type or the wrong number of arguments results in a compiler error instead of the
+ * kernel_parameter_type_mismatch and kernel_number_of_parameters_mismatch exceptions thrown by @c cupp::kernel.
+ * The price is that the type of the __global__ function is part of the type of the kernel.
+ * @example typed_kernel<void (*)(int, deviceT::vector<int>&)> k (&global_function);
+ */
+template< typename F_ >
+class typed_kernel {
+	public:
+		/**
+		 * @typedef F
+		 * @brief The function type of the __global__ cuda function
+		 */
+		typedef typename boost::remove_pointer<F_>::type F;
+
+		/**
+		 * This is the arity of the function.
+		 */
+		enum { arity = boost::function_traits<F>::arity };
+
+		/**
+		 * @brief Constructor used to generate a kernel
+		 * @param f A pointer to the kernel function
+		 * @param shared_mem The number of dynamic shared memory needed by this kernel (in bytes)
+		 * @param stream The stream the kernel is launched in, if no stream is passed to operator()
+		 */
+		typed_kernel( F_ f, const size_t shared_mem=0, cudaStream_t stream = 0) :
+		func_(f), shared_mem_(shared_mem), stream_(stream), lazy_write_back_(false) {}
+
+		/**
+		 * @brief Constructor used to generate a kernel
+		 * @param f A pointer to the kernel function
+		 * @param grid_dim The dimension of the grid, the kernel we be executed on
+		 * @param block_dim The dimension of the block, the kernel we be executed on
+		 * @param shared_mem The number of dynamic shared memory needed by this kernel (in bytes)
+		 * @param stream The stream the kernel is launched in, if no stream is passed to operator()
+		 */
+		typed_kernel( F_ f, const dim3 &grid_dim, const dim3 &block_dim, const size_t shared_mem=0, cudaStream_t stream = 0) :
+		func_(f), grid_dim_(grid_dim), block_dim_(block_dim), shared_mem_(shared_mem), stream_(stream), lazy_write_back_(false) {}
+
+		/**
+		 * @brief Change the grid dimension
+		 */
+		void set_grid_dim ( const dim3& grid_dim ) { grid_dim_ = grid_dim; }
+
+		/**
+		 * @return The current grid dimension
+		 */
+		dim3 grid_dim ( ) { return grid_dim_; }
+
+		/**
+		 * @brief Change the block dimension
+		 */
+		void set_block_dim ( const dim3& block_dim ) { block_dim_ = block_dim; }
+
+		/**
+		 * @return The current block dimension
+		 */
+		dim3 block_dim  ( ) { return block_dim_; }
+
+		/**
+		 * @brief Change the size of the dynamic shared memory
+		 */
+		void set_shared_mem ( const size_t& shared_mem ) { shared_mem_ = shared_mem; }
+
+		/**
+		 * @return The current size of dynamic shared memory
+		 */
+		size_t shared_mem ( ) { return shared_mem_; }
+
+		/**
+		 * @brief Change the stream the kernel is launched in, if no stream is passed to operator()
+		 */
+		void set_stream ( const stream& s ) { stream_ = s; }
+
+		/**
+		 * @return The stream the kernel is launched in, if no stream is passed to operator()
+		 */
+		const stream& get_stream ( ) { return stream_; }
+
+		/**
+		 * @brief Enables or disables lazy write-back, see @c cupp::kernel::set_lazy_write_back()
+		 */
+		void set_lazy_write_back ( const bool lazy ) { lazy_write_back_ = lazy; }
+
+		/**
+		 * @return true if lazy write-back is enabled
+		 */
+		bool lazy_write_back ( ) const { return lazy_write_back_; }
+
+		/**
+		 * @brief Calls the kernel.
+		 * @param d The device where you want the kernel to be executed on
+		 */
+		void operator()(const device &d);
+
+		/**
+		 * @brief Calls the kernel.
+		 * @param d The device where you want the kernel to be executed on
+		 * @param p1 The first parameter to be passed to the kernel
+		 */
+		template< typename P1 >
+		void operator()(const device &d, const P1 &p1 );
+
+		/**
+		 * @brief Calls the kernel.
+		 * @param d The device where you want the kernel to be executed on
+		 * @param p1 The first parameter to be passed to the kernel
+		 * @param p2 The second parameter to be passed to the kernel
+		 */
+		template< typename P1, typename P2 >
+		void operator()(const device &d, const P1 &p1, const P2 &p2 );
+
+		/**
+		 * @brief Calls the kernel.
+		 * @param d The device where you want the kernel to be executed on
+		 * @param p1 The first parameter to be passed to the kernel
+		 * @param p2 The second parameter to be passed to the kernel
+		 * @param p3 The third parameter to be passed to the kernel
+		 */
+		template< typename P1, typename P2, typename P3 >
+		void operator()(const device &d, const P1 &p1, const P2 &p2, const P3 &p3 );
+
+		/**
+		 * @brief Calls the kernel.
+		 * @param d The device where you want the kernel to be executed on
+		 * @param p1 The first parameter to be passed to the kernel
+		 * @param p2 The second parameter to be passed to the kernel
+		 * @param p3 The third parameter to be passed to the kernel
+		 * @param p4 ...
+		 */
+		template< typename P1, typename P2, typename P3, typename P4 >
+		void operator()(const device &d, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4 );
+
+		/**
+		 * @brief Calls the kernel.
+		 * @param d The device where you want the kernel to be executed on
+		 * @param p1 The first parameter to be passed to the kernel
+		 * @param p2 The second parameter to be passed to the kernel
+		 * @param p3 The third parameter to be passed to the kernel
+		 * @param p4 ...
+		 * @param p5 ...
+		 */
+		template< typename P1, typename P2, typename P3, typename P4, typename P5 >
+		void operator()(const device &d, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5 );
+
+		/**
+		 * @brief Calls the kernel.
+		 * @param d The device where you want the kernel to be executed on
+		 * @param p1 The first parameter to be passed to the kernel
+		 * @param p2 The second parameter to be passed to the kernel
+		 * @param p3 The third parameter to be passed to the kernel
+		 * @param p4 ...
+		 * @param p5 ...
+		 * @param p6 ...
+		 */
+		template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6 >
+		void operator()(const device &d, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6 );
+
+		/**
+		 * @brief Calls the kernel.
+		 * @param d The device where you want the kernel to be executed on
+		 * @param p1 The first parameter to be passed to the kernel
+		 * @param p2 The second parameter to be passed to the kernel
+		 * @param p3 The third parameter to be passed to the kernel
+		 * @param p4 ...
+		 * @param p5 ...
+		 * @param p6 ...
+		 * @param p7 ...
+		 */
+		template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7 >
+		void operator()(const device &d, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7 );
+
+		/**
+		 * @brief Calls the kernel.
+		 * @param d The device where you want the kernel to be executed on
+		 * @param p1 The first parameter to be passed to the kernel
+		 * @param p2 The second parameter to be passed to the kernel
+		 * @param p3 The third parameter to be passed to the kernel
+		 * @param p4 ...
+		 * @param p5 ...
+		 * @param p6 ...
+		 * @param p7 ...
+		 * @param p8 ...
+		 */
+		template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7, typename P8 >
+		void operator()(const device &d, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7, const P8 &p8 );
+
+		/**
+		 * @brief Calls the kernel.
+		 * @param d The device where you want the kernel to be executed on
+		 * @param p1 The first parameter to be passed to the kernel
+		 * @param p2 The second parameter to be passed to the kernel
+		 * @param p3 The third parameter to be passed to the kernel
+		 * @param p4 ...
+		 * @param p5 ...
+		 * @param p6 ...
+		 * @param p7 ...
+		 * @param p8 ...
+		 * @param p9 ...
+		 */
+		template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7, typename P8, typename P9 >
+		void operator()(const device &d, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7, const P8 &p8, const P9 &p9 );
+
+		/**
+		 * @brief Calls the kernel.
+		 * @param d The device where you want the kernel to be executed on
+		 * @param p1 The first parameter to be passed to the kernel
+		 * @param p2 The second parameter to be passed to the kernel
+		 * @param p3 The third parameter to be passed to the kernel
+		 * @param p4 ...
+		 * @param p5 ...
+		 * @param p6 ...
+		 * @param p7 ...
+		 * @param p8 ...
+		 * @param p9 ...
+		 * @param p10 ...
+		 */
+		template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7, typename P8, typename P9, typename P10 >
+		void operator()(const device &d, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7, const P8 &p8, const P9 &p9, const P10 &p10 );
+
+		/**
+		 * @brief Calls the kernel.
+		 * @param d The device where you want the kernel to be executed on
+		 * @param p1 The first parameter to be passed to the kernel
+		 * @param p2 The second parameter to be passed to the kernel
+		 * @param p3 The third parameter to be passed to the kernel
+		 * @param p4 ...
+		 * @param p5 ...
+		 * @param p6 ...
+		 * @param p7 ...
+		 * @param p8 ...
+		 * @param p9 ...
+		 * @param p10 ...
+		 * @param p11 ...
+		 */
+		template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7, typename P8, typename P9, typename P10, typename P11 >
+		void operator()(const device &d, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7, const P8 &p8, const P9 &p9, const P10 &p10, const P11 &p11 );
+
+		/**
+		 * @brief Calls the kernel.
+		 * @param d The device where you want the kernel to be executed on
+		 * @param p1 The first parameter to be passed to the kernel
+		 * @param p2 The second parameter to be passed to the kernel
+		 * @param p3 The third parameter to be passed to the kernel
+		 * @param p4 ...
+		 * @param p5 ...
+		 * @param p6 ...
+		 * @param p7 ...
+		 * @param p8 ...
+		 * @param p9 ...
+		 * @param p10 ...
+		 * @param p11 ...
+		 * @param p12 ...
+		 */
+		template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7, typename P8, typename P9, typename P10, typename P11, typename P12 >
+		void operator()(const device &d, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7, const P8 &p8, const P9 &p9, const P10 &p10, const P11 &p11, const P12 &p12 );
+
+		/**
+		 * @brief Calls the kernel.
+		 * @param d The device where you want the kernel to be executed on
+		 * @param p1 The first parameter to be passed to the kernel
+		 * @param p2 The second parameter to be passed to the kernel
+		 * @param p3 The third parameter to be passed to the kernel
+		 * @param p4 ...
+		 * @param p5 ...
+		 * @param p6 ...
+		 * @param p7 ...
+		 * @param p8 ...
+		 * @param p9 ...
+		 * @param p10 ...
+		 * @param p11 ...
+		 * @param p12 ...
+		 * @param p13 ...
+		 */
+		template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7, typename P8, typename P9, typename P10, typename P11, typename P12, typename P13 >
+		void operator()(const device &d, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7, const P8 &p8, const P9 &p9, const P10 &p10, const P11 &p11, const P12 &p12, const P13 &p13 );
+
+		/**
+		 * @brief Calls the kernel.
+		 * @param d The device where you want the kernel to be executed on
+		 * @param p1 The first parameter to be passed to the kernel
+		 * @param p2 The second parameter to be passed to the kernel
+		 * @param p3 The third parameter to be passed to the kernel
+		 * @param p4 ...
+		 * @param p5 ...
+		 * @param p6 ...
+		 * @param p7 ...
+		 * @param p8 ...
+		 * @param p9 ...
+		 * @param p10 ...
+		 * @param p11 ...
+		 * @param p12 ...
+		 * @param p13 ...
+		 * @param p14 ...
+		 */
+		template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7, typename P8, typename P9, typename P10, typename P11, typename P12, typename P13, typename P14 >
+		void operator()(const device &d, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7, const P8 &p8, const P9 &p9, const P10 &p10, const P11 &p11, const P12 &p12, const P13 &p13, const P14 &p14 );
+
+		/**
+		 * @brief Calls the kernel.
+		 * @param d The device where you want the kernel to be executed on
+		 * @param p1 The first parameter to be passed to the kernel
+		 * @param p2 The second parameter to be passed to the kernel
+		 * @param p3 The third parameter to be passed to the kernel
+		 * @param p4 ...
+		 * @param p5 ...
+		 * @param p6 ...
+		 * @param p7 ...
+		 * @param p8 ...
+		 * @param p9 ...
+		 * @param p10 ...
+		 * @param p11 ...
+		 * @param p12 ...
+		 * @param p13 ...
+		 * @param p14 ...
+		 * @param p15 ...
+		 */
+		template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7, typename P8, typename P9, typename P10, typename P11, typename P12, typename P13, typename P14, typename P15 >
+		void operator()(const device &d, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7, const P8 &p8, const P9 &p9, const P10 &p10, const P11 &p11, const P12 &p12, const P13 &p13, const P14 &p14, const P15 &p15 );
+
+		/**
+		 * @brief Calls the kernel.
+		 * @param d The device where you want the kernel to be executed on
+		 * @param p1 The first parameter to be passed to the kernel
+		 * @param p2 The second parameter to be passed to the kernel
+		 * @param p3 The third parameter to be passed to the kernel
+		 * @param p4 ...
+		 * @param p5 ...
+		 * @param p6 ...
+		 * @param p7 ...
+		 * @param p8 ...
+		 * @param p9 ...
+		 * @param p10 ...
+		 * @param p11 ...
+		 * @param p12 ...
+		 * @param p13 ...
+		 * @param p14 ...
+		 * @param p15 ...
+		 * @param p16 ...
+		 */
+		template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7, typename P8, typename P9, typename P10, typename P11, typename P12, typename P13, typename P14, typename P15, typename P16 >
+		void operator()(const device &d, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7, const P8 &p8, const P9 &p9, const P10 &p10, const P11 &p11, const P12 &p12, const P13 &p13, const P14 &p14, const P15 &p15, const P16 &p16 );
+
+		/**
+		 * @brief Calls the kernel in the stream @a s.
+		 * @param d The device where you want the kernel to be executed on
+		 * @param s The stream the kernel and the transfers of its parameters are enqueued in
+		 */
+		void operator()(const device &d, const stream &s);
+
+		/**
+		 * @brief Calls the kernel in the stream @a s.
+		 * @param d The device where you want the kernel to be executed on
+		 * @param s The stream the kernel and the transfers of its parameters are enqueued in
+		 * @param p1 The first parameter to be passed to the kernel
+		 */
+		template< typename P1 >
+		void operator()(const device &d, const stream &s, const P1 &p1 );
+
+		/**
+		 * @brief Calls the kernel in the stream @a s.
+		 * @param d The device where you want the kernel to be executed on
+		 * @param s The stream the kernel and the transfers of its parameters are enqueued in
+		 * @param p1 The first parameter to be passed to the kernel
+		 * @param p2 The second parameter to be passed to the kernel
+		 */
+		template< typename P1, typename P2 >
+		void operator()(const device &d, const stream &s, const P1 &p1, const P2 &p2 );
+
+		/**
+		 * @brief Calls the kernel in the stream @a s.
+		 * @param d The device where you want the kernel to be executed on
+		 * @param s The stream the kernel and the transfers of its parameters are enqueued in
+		 * @param p1 The first parameter to be passed to the kernel
+		 * @param p2 The second parameter to be passed to the kernel
+		 * @param p3 The third parameter to be passed to the kernel
+		 */
+		template< typename P1, typename P2, typename P3 >
+		void operator()(const device &d, const stream &s, const P1 &p1, const P2 &p2, const P3 &p3 );
+
+		/**
+		 * @brief Calls the kernel in the stream @a s.
+		 * @param d The device where you want the kernel to be executed on
+		 * @param s The stream the kernel and the transfers of its parameters are enqueued in
+		 * @param p1 The first parameter to be passed to the kernel
+		 * @param p2 The second parameter to be passed to the kernel
+		 * @param p3 The third parameter to be passed to the kernel
+		 * @param p4 ...
+		 */
+		template< typename P1, typename P2, typename P3, typename P4 >
+		void operator()(const device &d, const stream &s, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4 );
+
+		/**
+		 * @brief Calls the kernel in the stream @a s.
+		 * @param d The device where you want the kernel to be executed on
+		 * @param s The stream the kernel and the transfers of its parameters are enqueued in
+		 * @param p1 The first parameter to be passed to the kernel
+		 * @param p2 The second parameter to be passed to the kernel
+		 * @param p3 The third parameter to be passed to the kernel
+		 * @param p4 ...
+		 * @param p5 ...
+		 */
+		template< typename P1, typename P2, typename P3, typename P4, typename P5 >
+		void operator()(const device &d, const stream &s, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5 );
+
+		/**
+		 * @brief Calls the kernel in the stream @a s.
+		 * @param d The device where you want the kernel to be executed on
+		 * @param s The stream the kernel and the transfers of its parameters are enqueued in
+		 * @param p1 The first parameter to be passed to the kernel
+		 * @param p2 The second parameter to be passed to the kernel
+		 * @param p3 The third parameter to be passed to the kernel
+		 * @param p4 ...
+		 * @param p5 ...
+		 * @param p6 ...
+		 */
+		template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6 >
+		void operator()(const device &d, const stream &s, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6 );
+
+		/**
+		 * @brief Calls the kernel in the stream @a s.
+		 * @param d The device where you want the kernel to be executed on
+		 * @param s The stream the kernel and the transfers of its parameters are enqueued in
+		 * @param p1 The first parameter to be passed to the kernel
+		 * @param p2 The second parameter to be passed to the kernel
+		 * @param p3 The third parameter to be passed to the kernel
+		 * @param p4 ...
+		 * @param p5 ...
+		 * @param p6 ...
+		 * @param p7 ...
+		 */
+		template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7 >
+		void operator()(const device &d, const stream &s, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7 );
+
+		/**
+		 * @brief Calls the kernel in the stream @a s.
+		 * @param d The device where you want the kernel to be executed on
+		 * @param s The stream the kernel and the transfers of its parameters are enqueued in
+		 * @param p1 The first parameter to be passed to the kernel
+		 * @param p2 The second parameter to be passed to the kernel
+		 * @param p3 The third parameter to be passed to the kernel
+		 * @param p4 ...
+		 * @param p5 ...
+		 * @param p6 ...
+		 * @param p7 ...
+		 * @param p8 ...
+		 */
+		template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7, typename P8 >
+		void operator()(const device &d, const stream &s, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7, const P8 &p8 );
+
+		/**
+		 * @brief Calls the kernel in the stream @a s.
+		 * @param d The device where you want the kernel to be executed on
+		 * @param s The stream the kernel and the transfers of its parameters are enqueued in
+		 * @param p1 The first parameter to be passed to the kernel
+		 * @param p2 The second parameter to be passed to the kernel
+		 * @param p3 The third parameter to be passed to the kernel
+		 * @param p4 ...
+		 * @param p5 ...
+		 * @param p6 ...
+		 * @param p7 ...
+		 * @param p8 ...
+		 * @param p9 ...
+		 */
+		template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7, typename P8, typename P9 >
+		void operator()(const device &d, const stream &s, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7, const P8 &p8, const P9 &p9 );
+
+		/**
+		 * @brief Calls the kernel in the stream @a s.
+		 * @param d The device where you want the kernel to be executed on
+		 * @param s The stream the kernel and the transfers of its parameters are enqueued in
+		 * @param p1 The first parameter to be passed to the kernel
+		 * @param p2 The second parameter to be passed to the kernel
+		 * @param p3 The third parameter to be passed to the kernel
+		 * @param p4 ...
+		 * @param p5 ...
+		 * @param p6 ...
+		 * @param p7 ...
+		 * @param p8 ...
+		 * @param p9 ...
+		 * @param p10 ...
+		 */
+		template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7, typename P8, typename P9, typename P10 >
+		void operator()(const device &d, const stream &s, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7, const P8 &p8, const P9 &p9, const P10 &p10 );
+
+		/**
+		 * @brief Calls the kernel in the stream @a s.
+		 * @param d The device where you want the kernel to be executed on
+		 * @param s The stream the kernel and the transfers of its parameters are enqueued in
+		 * @param p1 The first parameter to be passed to the kernel
+		 * @param p2 The second parameter to be passed to the kernel
+		 * @param p3 The third parameter to be passed to the kernel
+		 * @param p4 ...
+		 * @param p5 ...
+		 * @param p6 ...
+		 * @param p7 ...
+		 * @param p8 ...
+		 * @param p9 ...
+		 * @param p10 ...
+		 * @param p11 ...
+		 */
+		template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7, typename P8, typename P9, typename P10, typename P11 >
+		void operator()(const device &d, const stream &s, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7, const P8 &p8, const P9 &p9, const P10 &p10, const P11 &p11 );
+
+		/**
+		 * @brief Calls the kernel in the stream @a s.
+		 * @param d The device where you want the kernel to be executed on
+		 * @param s The stream the kernel and the transfers of its parameters are enqueued in
+		 * @param p1 The first parameter to be passed to the kernel
+		 * @param p2 The second parameter to be passed to the kernel
+		 * @param p3 The third parameter to be passed to the kernel
+		 * @param p4 ...
+		 * @param p5 ...
+		 * @param p6 ...
+		 * @param p7 ...
+		 * @param p8 ...
+		 * @param p9 ...
+		 * @param p10 ...
+		 * @param p11 ...
+		 * @param p12 ...
+		 */
+		template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7, typename P8, typename P9, typename P10, typename P11, typename P12 >
+		void operator()(const device &d, const stream &s, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7, const P8 &p8, const P9 &p9, const P10 &p10, const P11 &p11, const P12 &p12 );
+
+		/**
+		 * @brief Calls the kernel in the stream @a s.
+		 * @param d The device where you want the kernel to be executed on
+		 * @param s The stream the kernel and the transfers of its parameters are enqueued in
+		 * @param p1 The first parameter to be passed to the kernel
+		 * @param p2 The second parameter to be passed to the kernel
+		 * @param p3 The third parameter to be passed to the kernel
+		 * @param p4 ...
+		 * @param p5 ...
+		 * @param p6 ...
+		 * @param p7 ...
+		 * @param p8 ...
+		 * @param p9 ...
+		 * @param p10 ...
+		 * @param p11 ...
+		 * @param p12 ...
+		 * @param p13 ...
+		 */
+		template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7, typename P8, typename P9, typename P10, typename P11, typename P12, typename P13 >
+		void operator()(const device &d, const stream &s, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7, const P8 &p8, const P9 &p9, const P10 &p10, const P11 &p11, const P12 &p12, const P13 &p13 );
+
+		/**
+		 * @brief Calls the kernel in the stream @a s.
+		 * @param d The device where you want the kernel to be executed on
+		 * @param s The stream the kernel and the transfers of its parameters are enqueued in
+		 * @param p1 The first parameter to be passed to the kernel
+		 * @param p2 The second parameter to be passed to the kernel
+		 * @param p3 The third parameter to be passed to the kernel
+		 * @param p4 ...
+		 * @param p5 ...
+		 * @param p6 ...
+		 * @param p7 ...
+		 * @param p8 ...
+		 * @param p9 ...
+		 * @param p10 ...
+		 * @param p11 ...
+		 * @param p12 ...
+		 * @param p13 ...
+		 * @param p14 ...
+		 */
+		template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7, typename P8, typename P9, typename P10, typename P11, typename P12, typename P13, typename P14 >
+		void operator()(const device &d, const stream &s, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7, const P8 &p8, const P9 &p9, const P10 &p10, const P11 &p11, const P12 &p12, const P13 &p13, const P14 &p14 );
+
+		/**
+		 * @brief Calls the kernel in the stream @a s.
+		 * @param d The device where you want the kernel to be executed on
+		 * @param s The stream the kernel and the transfers of its parameters are enqueued in
+		 * @param p1 The first parameter to be passed to the kernel
+		 * @param p2 The second parameter to be passed to the kernel
+		 * @param p3 The third parameter to be passed to the kernel
+		 * @param p4 ...
+		 * @param p5 ...
+		 * @param p6 ...
+		 * @param p7 ...
+		 * @param p8 ...
+		 * @param p9 ...
+		 * @param p10 ...
+		 * @param p11 ...
+		 * @param p12 ...
+		 * @param p13 ...
+		 * @param p14 ...
+		 * @param p15 ...
+		 */
+		template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7, typename P8, typename P9, typename P10, typename P11, typename P12, typename P13, typename P14, typename P15 >
+		void operator()(const device &d, const stream &s, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7, const P8 &p8, const P9 &p9, const P10 &p10, const P11 &p11, const P12 &p12, const P13 &p13, const P14 &p14, const P15 &p15 );
+
+		/**
+		 * @brief Calls the kernel in the stream @a s.
+		 * @param d The device where you want the kernel to be executed on
+		 * @param s The stream the kernel and the transfers of its parameters are enqueued in
+		 * @param p1 The first parameter to be passed to the kernel
+		 * @param p2 The second parameter to be passed to the kernel
+		 * @param p3 The third parameter to be passed to the kernel
+		 * @param p4 ...
+		 * @param p5 ...
+		 * @param p6 ...
+		 * @param p7 ...
+		 * @param p8 ...
+		 * @param p9 ...
+		 * @param p10 ...
+		 * @param p11 ...
+		 * @param p12 ...
+		 * @param p13 ...
+		 * @param p14 ...
+		 * @param p15 ...
+		 * @param p16 ...
+		 */
+		template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7, typename P8, typename P9, typename P10, typename P11, typename P12, typename P13, typename P14, typename P15, typename P16 >
+		void operator()(const device &d, const stream &s, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7, const P8 &p8, const P9 &p9, const P10 &p10, const P11 &p11, const P12 &p12, const P13 &p13, const P14 &p14, const P15 &p15, const P16 &p16 );
+
+	private:
+		/**
+		 * @brief How argument @a P passed to parameter @a pos is handled
+		 */
+		template <int pos, typename P>
+		struct argument : public kernel_impl::static_argument<typename kernel_impl::parameter_type<F, pos>::type, P> {};
+
+		/**
+		 * @brief Calls the __global__ function with the arguments on @a stack
+		 */
+		void launch(kernel_impl::argument_stack &stack);
+
+		/**
+		 * @brief Launches the kernel in another stream for its lifetime
+		 */
+		class stream_switch {
+			public:
+				stream_switch (typed_kernel &k, const stream &s) : k_(k), old_(k.stream_) {
+					k_.stream_ = s;
+				}
+				~stream_switch() {
+					k_.stream_ = old_;
+				}
+			private:
+				typed_kernel &k_;
+				stream old_;
+		};
+
+	private:
+		/**
+		 * A pointer to the __global__ cuda function.
+		 */
+		F* func_;
+
+		/**
+		 * Grid dimension
+		 */
+		dim3 grid_dim_;
+
+		/**
+		 * Block dimension
+		 */
+		dim3 block_dim_;
+
+		/**
+		 * The size of the shared memory
+		 */
+		size_t shared_mem_;
+
+		/**
+		 * The stream the kernel is launched in
+		 */
+		stream stream_;
+
+		/**
+		 * true if the by-reference parameters are written back lazily
+		 */
+		bool lazy_write_back_;
+};
+
+
+template< typename F_ >
+void typed_kernel<F_>::launch(kernel_impl::argument_stack &stack) {
+	stack.launch((const void*)func_, grid_dim_, block_dim_, shared_mem_, stream_.get());
+}
+
+
+
+/***  OPERATPR()  ***/
+template< typename F_ >
+void typed_kernel<F_>::operator()(const device &d) {
+	BOOST_STATIC_ASSERT(arity == 0);
+	UNUSED_PARAMETER(d);
+
+	kernel_impl::argument_stack stack;
+	launch(stack);
+}
+
+template< typename F_ >
+template< typename P1 >
+void typed_kernel<F_>::operator()(const device &d, const P1 &p1 ) {
+	BOOST_STATIC_ASSERT(arity == 1);
+	// transfers of our parameters go into our stream, the per launch objects into one arena
+	kernel_impl::launch_scope scope (stream_);
+	kernel_impl::argument_stack stack;
+
+	typename argument<1, P1>::holder h1 = argument<1, P1>::setup (d, p1, stack);
+
+	launch(stack);
+
+	argument<1, P1>::finish (p1, h1, lazy_write_back_);
+}
+
+template< typename F_ >
+template< typename P1, typename P2 >
+void typed_kernel<F_>::operator()(const device &d, const P1 &p1, const P2 &p2 ) {
+	BOOST_STATIC_ASSERT(arity == 2);
+	// transfers of our parameters go into our stream, the per launch objects into one arena
+	kernel_impl::launch_scope scope (stream_);
+	kernel_impl::argument_stack stack;
+
+	typename argument<1, P1>::holder h1 = argument<1, P1>::setup (d, p1, stack);
+	typename argument<2, P2>::holder h2 = argument<2, P2>::setup (d, p2, stack);
+
+	launch(stack);
+
+	argument<1, P1>::finish (p1, h1, lazy_write_back_);
+	argument<2, P2>::finish (p2, h2, lazy_write_back_);
+}
+
+template< typename F_ >
+template< typename P1, typename P2, typename P3 >
+void typed_kernel<F_>::operator()(const device &d, const P1 &p1, const P2 &p2, const P3 &p3 ) {
+	BOOST_STATIC_ASSERT(arity == 3);
+	// transfers of our parameters go into our stream, the per launch objects into one arena
+	kernel_impl::launch_scope scope (stream_);
+	kernel_impl::argument_stack stack;
+
+	typename argument<1, P1>::holder h1 = argument<1, P1>::setup (d, p1, stack);
+	typename argument<2, P2>::holder h2 = argument<2, P2>::setup (d, p2, stack);
+	typename argument<3, P3>::holder h3 = argument<3, P3>::setup (d, p3, stack);
+
+	launch(stack);
+
+	argument<1, P1>::finish (p1, h1, lazy_write_back_);
+	argument<2, P2>::finish (p2, h2, lazy_write_back_);
+	argument<3, P3>::finish (p3, h3, lazy_write_back_);
+}
+
+template< typename F_ >
+template< typename P1, typename P2, typename P3, typename P4 >
+void typed_kernel<F_>::operator()(const device &d, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4 ) {
+	BOOST_STATIC_ASSERT(arity == 4);
+	// transfers of our parameters go into our stream, the per launch objects into one arena
+	kernel_impl::launch_scope scope (stream_);
+	kernel_impl::argument_stack stack;
+
+	typename argument<1, P1>::holder h1 = argument<1, P1>::setup (d, p1, stack);
+	typename argument<2, P2>::holder h2 = argument<2, P2>::setup (d, p2, stack);
+	typename argument<3, P3>::holder h3 = argument<3, P3>::setup (d, p3, stack);
+	typename argument<4, P4>::holder h4 = argument<4, P4>::setup (d, p4, stack);
+
+	launch(stack);
+
+	argument<1, P1>::finish (p1, h1, lazy_write_back_);
+	argument<2, P2>::finish (p2, h2, lazy_write_back_);
+	argument<3, P3>::finish (p3, h3, lazy_write_back_);
+	argument<4, P4>::finish (p4, h4, lazy_write_back_);
+}
+
+template< typename F_ >
+template< typename P1, typename P2, typename P3, typename P4, typename P5 >
+void typed_kernel<F_>::operator()(const device &d, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5 ) {
+	BOOST_STATIC_ASSERT(arity == 5);
+	// transfers of our parameters go into our stream, the per launch objects into one arena
+	kernel_impl::launch_scope scope (stream_);
+	kernel_impl::argument_stack stack;
+
+	typename argument<1, P1>::holder h1 = argument<1, P1>::setup (d, p1, stack);
+	typename argument<2, P2>::holder h2 = argument<2, P2>::setup (d, p2, stack);
+	typename argument<3, P3>::holder h3 = argument<3, P3>::setup (d, p3, stack);
+	typename argument<4, P4>::holder h4 = argument<4, P4>::setup (d, p4, stack);
+	typename argument<5, P5>::holder h5 = argument<5, P5>::setup (d, p5, stack);
+
+	launch(stack);
+
+	argument<1, P1>::finish (p1, h1, lazy_write_back_);
+	argument<2, P2>::finish (p2, h2, lazy_write_back_);
+	argument<3, P3>::finish (p3, h3, lazy_write_back_);
+	argument<4, P4>::finish (p4, h4, lazy_write_back_);
+	argument<5, P5>::finish (p5, h5, lazy_write_back_);
+}
+
+template< typename F_ >
+template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6 >
+void typed_kernel<F_>::operator()(const device &d, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6 ) {
+	BOOST_STATIC_ASSERT(arity == 6);
+	// transfers of our parameters go into our stream, the per launch objects into one arena
+	kernel_impl::launch_scope scope (stream_);
+	kernel_impl::argument_stack stack;
+
+	typename argument<1, P1>::holder h1 = argument<1, P1>::setup (d, p1, stack);
+	typename argument<2, P2>::holder h2 = argument<2, P2>::setup (d, p2, stack);
+	typename argument<3, P3>::holder h3 = argument<3, P3>::setup (d, p3, stack);
+	typename argument<4, P4>::holder h4 = argument<4, P4>::setup (d, p4, stack);
+	typename argument<5, P5>::holder h5 = argument<5, P5>::setup (d, p5, stack);
+	typename argument<6, P6>::holder h6 = argument<6, P6>::setup (d, p6, stack);
+
+	launch(stack);
+
+	argument<1, P1>::finish (p1, h1, lazy_write_back_);
+	argument<2, P2>::finish (p2, h2, lazy_write_back_);
+	argument<3, P3>::finish (p3, h3, lazy_write_back_);
+	argument<4, P4>::finish (p4, h4, lazy_write_back_);
+	argument<5, P5>::finish (p5, h5, lazy_write_back_);
+	argument<6, P6>::finish (p6, h6, lazy_write_back_);
+}
+
+template< typename F_ >
+template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7 >
+void typed_kernel<F_>::operator()(const device &d, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7 ) {
+	BOOST_STATIC_ASSERT(arity == 7);
+	// transfers of our parameters go into our stream, the per launch objects into one arena
+	kernel_impl::launch_scope scope (stream_);
+	kernel_impl::argument_stack stack;
+
+	typename argument<1, P1>::holder h1 = argument<1, P1>::setup (d, p1, stack);
+	typename argument<2, P2>::holder h2 = argument<2, P2>::setup (d, p2, stack);
+	typename argument<3, P3>::holder h3 = argument<3, P3>::setup (d, p3, stack);
+	typename argument<4, P4>::holder h4 = argument<4, P4>::setup (d, p4, stack);
+	typename argument<5, P5>::holder h5 = argument<5, P5>::setup (d, p5, stack);
+	typename argument<6, P6>::holder h6 = argument<6, P6>::setup (d, p6, stack);
+	typename argument<7, P7>::holder h7 = argument<7, P7>::setup (d, p7, stack);
+
+	launch(stack);
+
+	argument<1, P1>::finish (p1, h1, lazy_write_back_);
+	argument<2, P2>::finish (p2, h2, lazy_write_back_);
+	argument<3, P3>::finish (p3, h3, lazy_write_back_);
+	argument<4, P4>::finish (p4, h4, lazy_write_back_);
+	argument<5, P5>::finish (p5, h5, lazy_write_back_);
+	argument<6, P6>::finish (p6, h6, lazy_write_back_);
+	argument<7, P7>::finish (p7, h7, lazy_write_back_);
+}
+
+template< typename F_ >
+template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7, typename P8 >
+void typed_kernel<F_>::operator()(const device &d, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7, const P8 &p8 ) {
+	BOOST_STATIC_ASSERT(arity == 8);
+	// transfers of our parameters go into our stream, the per launch objects into one arena
+	kernel_impl::launch_scope scope (stream_);
+	kernel_impl::argument_stack stack;
+
+	typename argument<1, P1>::holder h1 = argument<1, P1>::setup (d, p1, stack);
+	typename argument<2, P2>::holder h2 = argument<2, P2>::setup (d, p2, stack);
+	typename argument<3, P3>::holder h3 = argument<3, P3>::setup (d, p3, stack);
+	typename argument<4, P4>::holder h4 = argument<4, P4>::setup (d, p4, stack);
+	typename argument<5, P5>::holder h5 = argument<5, P5>::setup (d, p5, stack);
+	typename argument<6, P6>::holder h6 = argument<6, P6>::setup (d, p6, stack);
+	typename argument<7, P7>::holder h7 = argument<7, P7>::setup (d, p7, stack);
+	typename argument<8, P8>::holder h8 = argument<8, P8>::setup (d, p8, stack);
+
+	launch(stack);
+
+	argument<1, P1>::finish (p1, h1, lazy_write_back_);
+	argument<2, P2>::finish (p2, h2, lazy_write_back_);
+	argument<3, P3>::finish (p3, h3, lazy_write_back_);
+	argument<4, P4>::finish (p4, h4, lazy_write_back_);
+	argument<5, P5>::finish (p5, h5, lazy_write_back_);
+	argument<6, P6>::finish (p6, h6, lazy_write_back_);
+	argument<7, P7>::finish (p7, h7, lazy_write_back_);
+	argument<8, P8>::finish (p8, h8, lazy_write_back_);
+}
+
+template< typename F_ >
+template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7, typename P8, typename P9 >
+void typed_kernel<F_>::operator()(const device &d, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7, const P8 &p8, const P9 &p9 ) {
+	BOOST_STATIC_ASSERT(arity == 9);
+	// transfers of our parameters go into our stream, the per launch objects into one arena
+	kernel_impl::launch_scope scope (stream_);
+	kernel_impl::argument_stack stack;
+
+	typename argument<1, P1>::holder h1 = argument<1, P1>::setup (d, p1, stack);
+	typename argument<2, P2>::holder h2 = argument<2, P2>::setup (d, p2, stack);
+	typename argument<3, P3>::holder h3 = argument<3, P3>::setup (d, p3, stack);
+	typename argument<4, P4>::holder h4 = argument<4, P4>::setup (d, p4, stack);
+	typename argument<5, P5>::holder h5 = argument<5, P5>::setup (d, p5, stack);
+	typename argument<6, P6>::holder h6 = argument<6, P6>::setup (d, p6, stack);
+	typename argument<7, P7>::holder h7 = argument<7, P7>::setup (d, p7, stack);
+	typename argument<8, P8>::holder h8 = argument<8, P8>::setup (d, p8, stack);
+	typename argument<9, P9>::holder h9 = argument<9, P9>::setup (d, p9, stack);
+
+	launch(stack);
+
+	argument<1, P1>::finish (p1, h1, lazy_write_back_);
+	argument<2, P2>::finish (p2, h2, lazy_write_back_);
+	argument<3, P3>::finish (p3, h3, lazy_write_back_);
+	argument<4, P4>::finish (p4, h4, lazy_write_back_);
+	argument<5, P5>::finish (p5, h5, lazy_write_back_);
+	argument<6, P6>::finish (p6, h6, lazy_write_back_);
+	argument<7, P7>::finish (p7, h7, lazy_write_back_);
+	argument<8, P8>::finish (p8, h8, lazy_write_back_);
+	argument<9, P9>::finish (p9, h9, lazy_write_back_);
+}
+
+template< typename F_ >
+template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7, typename P8, typename P9, typename P10 >
+void typed_kernel<F_>::operator()(const device &d, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7, const P8 &p8, const P9 &p9, const P10 &p10 ) {
+	BOOST_STATIC_ASSERT(arity == 10);
+	// transfers of our parameters go into our stream, the per launch objects into one arena
+	kernel_impl::launch_scope scope (stream_);
+	kernel_impl::argument_stack stack;
+
+	typename argument<1, P1>::holder h1 = argument<1, P1>::setup (d, p1, stack);
+	typename argument<2, P2>::holder h2 = argument<2, P2>::setup (d, p2, stack);
+	typename argument<3, P3>::holder h3 = argument<3, P3>::setup (d, p3, stack);
+	typename argument<4, P4>::holder h4 = argument<4, P4>::setup (d, p4, stack);
+	typename argument<5, P5>::holder h5 = argument<5, P5>::setup (d, p5, stack);
+	typename argument<6, P6>::holder h6 = argument<6, P6>::setup (d, p6, stack);
+	typename argument<7, P7>::holder h7 = argument<7, P7>::setup (d, p7, stack);
+	typename argument<8, P8>::holder h8 = argument<8, P8>::setup (d, p8, stack);
+	typename argument<9, P9>::holder h9 = argument<9, P9>::setup (d, p9, stack);
+	typename argument<10, P10>::holder h10 = argument<10, P10>::setup (d, p10, stack);
+
+	launch(stack);
+
+	argument<1, P1>::finish (p1, h1, lazy_write_back_);
+	argument<2, P2>::finish (p2, h2, lazy_write_back_);
+	argument<3, P3>::finish (p3, h3, lazy_write_back_);
+	argument<4, P4>::finish (p4, h4, lazy_write_back_);
+	argument<5, P5>::finish (p5, h5, lazy_write_back_);
+	argument<6, P6>::finish (p6, h6, lazy_write_back_);
+	argument<7, P7>::finish (p7, h7, lazy_write_back_);
+	argument<8, P8>::finish (p8, h8, lazy_write_back_);
+	argument<9, P9>::finish (p9, h9, lazy_write_back_);
+	argument<10, P10>::finish (p10, h10, lazy_write_back_);
+}
+
+template< typename F_ >
+template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7, typename P8, typename P9, typename P10, typename P11 >
+void typed_kernel<F_>::operator()(const device &d, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7, const P8 &p8, const P9 &p9, const P10 &p10, const P11 &p11 ) {
+	BOOST_STATIC_ASSERT(arity == 11);
+	// transfers of our parameters go into our stream, the per launch objects into one arena
+	kernel_impl::launch_scope scope (stream_);
+	kernel_impl::argument_stack stack;
+
+	typename argument<1, P1>::holder h1 = argument<1, P1>::setup (d, p1, stack);
+	typename argument<2, P2>::holder h2 = argument<2, P2>::setup (d, p2, stack);
+	typename argument<3, P3>::holder h3 = argument<3, P3>::setup (d, p3, stack);
+	typename argument<4, P4>::holder h4 = argument<4, P4>::setup (d, p4, stack);
+	typename argument<5, P5>::holder h5 = argument<5, P5>::setup (d, p5, stack);
+	typename argument<6, P6>::holder h6 = argument<6, P6>::setup (d, p6, stack);
+	typename argument<7, P7>::holder h7 = argument<7, P7>::setup (d, p7, stack);
+	typename argument<8, P8>::holder h8 = argument<8, P8>::setup (d, p8, stack);
+	typename argument<9, P9>::holder h9 = argument<9, P9>::setup (d, p9, stack);
+	typename argument<10, P10>::holder h10 = argument<10, P10>::setup (d, p10, stack);
+	typename argument<11, P11>::holder h11 = argument<11, P11>::setup (d, p11, stack);
+
+	launch(stack);
+
+	argument<1, P1>::finish (p1, h1, lazy_write_back_);
+	argument<2, P2>::finish (p2, h2, lazy_write_back_);
+	argument<3, P3>::finish (p3, h3, lazy_write_back_);
+	argument<4, P4>::finish (p4, h4, lazy_write_back_);
+	argument<5, P5>::finish (p5, h5, lazy_write_back_);
+	argument<6, P6>::finish (p6, h6, lazy_write_back_);
+	argument<7, P7>::finish (p7, h7, lazy_write_back_);
+	argument<8, P8>::finish (p8, h8, lazy_write_back_);
+	argument<9, P9>::finish (p9, h9, lazy_write_back_);
+	argument<10, P10>::finish (p10, h10, lazy_write_back_);
+	argument<11, P11>::finish (p11, h11, lazy_write_back_);
+}
+
+template< typename F_ >
+template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7, typename P8, typename P9, typename P10, typename P11, typename P12 >
+void typed_kernel<F_>::operator()(const device &d, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7, const P8 &p8, const P9 &p9, const P10 &p10, const P11 &p11, const P12 &p12 ) {
+	BOOST_STATIC_ASSERT(arity == 12);
+	// transfers of our parameters go into our stream, the per launch objects into one arena
+	kernel_impl::launch_scope scope (stream_);
+	kernel_impl::argument_stack stack;
+
+	typename argument<1, P1>::holder h1 = argument<1, P1>::setup (d, p1, stack);
+	typename argument<2, P2>::holder h2 = argument<2, P2>::setup (d, p2, stack);
+	typename argument<3, P3>::holder h3 = argument<3, P3>::setup (d, p3, stack);
+	typename argument<4, P4>::holder h4 = argument<4, P4>::setup (d, p4, stack);
+	typename argument<5, P5>::holder h5 = argument<5, P5>::setup (d, p5, stack);
+	typename argument<6, P6>::holder h6 = argument<6, P6>::setup (d, p6, stack);
+	typename argument<7, P7>::holder h7 = argument<7, P7>::setup (d, p7, stack);
+	typename argument<8, P8>::holder h8 = argument<8, P8>::setup (d, p8, stack);
+	typename argument<9, P9>::holder h9 = argument<9, P9>::setup (d, p9, stack);
+	typename argument<10, P10>::holder h10 = argument<10, P10>::setup (d, p10, stack);
+	typename argument<11, P11>::holder h11 = argument<11, P11>::setup (d, p11, stack);
+	typename argument<12, P12>::holder h12 = argument<12, P12>::setup (d, p12, stack);
+
+	launch(stack);
+
+	argument<1, P1>::finish (p1, h1, lazy_write_back_);
+	argument<2, P2>::finish (p2, h2, lazy_write_back_);
+	argument<3, P3>::finish (p3, h3, lazy_write_back_);
+	argument<4, P4>::finish (p4, h4, lazy_write_back_);
+	argument<5, P5>::finish (p5, h5, lazy_write_back_);
+	argument<6, P6>::finish (p6, h6, lazy_write_back_);
+	argument<7, P7>::finish (p7, h7, lazy_write_back_);
+	argument<8, P8>::finish (p8, h8, lazy_write_back_);
+	argument<9, P9>::finish (p9, h9, lazy_write_back_);
+	argument<10, P10>::finish (p10, h10, lazy_write_back_);
+	argument<11, P11>::finish (p11, h11, lazy_write_back_);
+	argument<12, P12>::finish (p12, h12, lazy_write_back_);
+}
+
+template< typename F_ >
+template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7, typename P8, typename P9, typename P10, typename P11, typename P12, typename P13 >
+void typed_kernel<F_>::operator()(const device &d, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7, const P8 &p8, const P9 &p9, const P10 &p10, const P11 &p11, const P12 &p12, const P13 &p13 ) {
+	BOOST_STATIC_ASSERT(arity == 13);
+	// transfers of our parameters go into our stream, the per launch objects into one arena
+	kernel_impl::launch_scope scope (stream_);
+	kernel_impl::argument_stack stack;
+
+	typename argument<1, P1>::holder h1 = argument<1, P1>::setup (d, p1, stack);
+	typename argument<2, P2>::holder h2 = argument<2, P2>::setup (d, p2, stack);
+	typename argument<3, P3>::holder h3 = argument<3, P3>::setup (d, p3, stack);
+	typename argument<4, P4>::holder h4 = argument<4, P4>::setup (d, p4, stack);
+	typename argument<5, P5>::holder h5 = argument<5, P5>::setup (d, p5, stack);
+	typename argument<6, P6>::holder h6 = argument<6, P6>::setup (d, p6, stack);
+	typename argument<7, P7>::holder h7 = argument<7, P7>::setup (d, p7, stack);
+	typename argument<8, P8>::holder h8 = argument<8, P8>::setup (d, p8, stack);
+	typename argument<9, P9>::holder h9 = argument<9, P9>::setup (d, p9, stack);
+	typename argument<10, P10>::holder h10 = argument<10, P10>::setup (d, p10, stack);
+	typename argument<11, P11>::holder h11 = argument<11, P11>::setup (d, p11, stack);
+	typename argument<12, P12>::holder h12 = argument<12, P12>::setup (d, p12, stack);
+	typename argument<13, P13>::holder h13 = argument<13, P13>::setup (d, p13, stack);
+
+	launch(stack);
+
+	argument<1, P1>::finish (p1, h1, lazy_write_back_);
+	argument<2, P2>::finish (p2, h2, lazy_write_back_);
+	argument<3, P3>::finish (p3, h3, lazy_write_back_);
+	argument<4, P4>::finish (p4, h4, lazy_write_back_);
+	argument<5, P5>::finish (p5, h5, lazy_write_back_);
+	argument<6, P6>::finish (p6, h6, lazy_write_back_);
+	argument<7, P7>::finish (p7, h7, lazy_write_back_);
+	argument<8, P8>::finish (p8, h8, lazy_write_back_);
+	argument<9, P9>::finish (p9, h9, lazy_write_back_);
+	argument<10, P10>::finish (p10, h10, lazy_write_back_);
+	argument<11, P11>::finish (p11, h11, lazy_write_back_);
+	argument<12, P12>::finish (p12, h12, lazy_write_back_);
+	argument<13, P13>::finish (p13, h13, lazy_write_back_);
+}
+
+template< typename F_ >
+template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7, typename P8, typename P9, typename P10, typename P11, typename P12, typename P13, typename P14 >
+void typed_kernel<F_>::operator()(const device &d, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7, const P8 &p8, const P9 &p9, const P10 &p10, const P11 &p11, const P12 &p12, const P13 &p13, const P14 &p14 ) {
+	BOOST_STATIC_ASSERT(arity == 14);
+	// transfers of our parameters go into our stream, the per launch objects into one arena
+	kernel_impl::launch_scope scope (stream_);
+	kernel_impl::argument_stack stack;
+
+	typename argument<1, P1>::holder h1 = argument<1, P1>::setup (d, p1, stack);
+	typename argument<2, P2>::holder h2 = argument<2, P2>::setup (d, p2, stack);
+	typename argument<3, P3>::holder h3 = argument<3, P3>::setup (d, p3, stack);
+	typename argument<4, P4>::holder h4 = argument<4, P4>::setup (d, p4, stack);
+	typename argument<5, P5>::holder h5 = argument<5, P5>::setup (d, p5, stack);
+	typename argument<6, P6>::holder h6 = argument<6, P6>::setup (d, p6, stack);
+	typename argument<7, P7>::holder h7 = argument<7, P7>::setup (d, p7, stack);
+	typename argument<8, P8>::holder h8 = argument<8, P8>::setup (d, p8, stack);
+	typename argument<9, P9>::holder h9 = argument<9, P9>::setup (d, p9, stack);
+	typename argument<10, P10>::holder h10 = argument<10, P10>::setup (d, p10, stack);
+	typename argument<11, P11>::holder h11 = argument<11, P11>::setup (d, p11, stack);
+	typename argument<12, P12>::holder h12 = argument<12, P12>::setup (d, p12, stack);
+	typename argument<13, P13>::holder h13 = argument<13, P13>::setup (d, p13, stack);
+	typename argument<14, P14>::holder h14 = argument<14, P14>::setup (d, p14, stack);
+
+	launch(stack);
+
+	argument<1, P1>::finish (p1, h1, lazy_write_back_);
+	argument<2, P2>::finish (p2, h2, lazy_write_back_);
+	argument<3, P3>::finish (p3, h3, lazy_write_back_);
+	argument<4, P4>::finish (p4, h4, lazy_write_back_);
+	argument<5, P5>::finish (p5, h5, lazy_write_back_);
+	argument<6, P6>::finish (p6, h6, lazy_write_back_);
+	argument<7, P7>::finish (p7, h7, lazy_write_back_);
+	argument<8, P8>::finish (p8, h8, lazy_write_back_);
+	argument<9, P9>::finish (p9, h9, lazy_write_back_);
+	argument<10, P10>::finish (p10, h10, lazy_write_back_);
+	argument<11, P11>::finish (p11, h11, lazy_write_back_);
+	argument<12, P12>::finish (p12, h12, lazy_write_back_);
+	argument<13, P13>::finish (p13, h13, lazy_write_back_);
+	argument<14, P14>::finish (p14, h14, lazy_write_back_);
+}
+
+template< typename F_ >
+template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7, typename P8, typename P9, typename P10, typename P11, typename P12, typename P13, typename P14, typename P15 >
+void typed_kernel<F_>::operator()(const device &d, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7, const P8 &p8, const P9 &p9, const P10 &p10, const P11 &p11, const P12 &p12, const P13 &p13, const P14 &p14, const P15 &p15 ) {
+	BOOST_STATIC_ASSERT(arity == 15);
+	// transfers of our parameters go into our stream, the per launch objects into one arena
+	kernel_impl::launch_scope scope (stream_);
+	kernel_impl::argument_stack stack;
+
+	typename argument<1, P1>::holder h1 = argument<1, P1>::setup (d, p1, stack);
+	typename argument<2, P2>::holder h2 = argument<2, P2>::setup (d, p2, stack);
+	typename argument<3, P3>::holder h3 = argument<3, P3>::setup (d, p3, stack);
+	typename argument<4, P4>::holder h4 = argument<4, P4>::setup (d, p4, stack);
+	typename argument<5, P5>::holder h5 = argument<5, P5>::setup (d, p5, stack);
+	typename argument<6, P6>::holder h6 = argument<6, P6>::setup (d, p6, stack);
+	typename argument<7, P7>::holder h7 = argument<7, P7>::setup (d, p7, stack);
+	typename argument<8, P8>::holder h8 = argument<8, P8>::setup (d, p8, stack);
+	typename argument<9, P9>::holder h9 = argument<9, P9>::setup (d, p9, stack);
+	typename argument<10, P10>::holder h10 = argument<10, P10>::setup (d, p10, stack);
+	typename argument<11, P11>::holder h11 = argument<11, P11>::setup (d, p11, stack);
+	typename argument<12, P12>::holder h12 = argument<12, P12>::setup (d, p12, stack);
+	typename argument<13, P13>::holder h13 = argument<13, P13>::setup (d, p13, stack);
+	typename argument<14, P14>::holder h14 = argument<14, P14>::setup (d, p14, stack);
+	typename argument<15, P15>::holder h15 = argument<15, P15>::setup (d, p15, stack);
+
+	launch(stack);
+
+	argument<1, P1>::finish (p1, h1, lazy_write_back_);
+	argument<2, P2>::finish (p2, h2, lazy_write_back_);
+	argument<3, P3>::finish (p3, h3, lazy_write_back_);
+	argument<4, P4>::finish (p4, h4, lazy_write_back_);
+	argument<5, P5>::finish (p5, h5, lazy_write_back_);
+	argument<6, P6>::finish (p6, h6, lazy_write_back_);
+	argument<7, P7>::finish (p7, h7, lazy_write_back_);
+	argument<8, P8>::finish (p8, h8, lazy_write_back_);
+	argument<9, P9>::finish (p9, h9, lazy_write_back_);
+	argument<10, P10>::finish (p10, h10, lazy_write_back_);
+	argument<11, P11>::finish (p11, h11, lazy_write_back_);
+	argument<12, P12>::finish (p12, h12, lazy_write_back_);
+	argument<13, P13>::finish (p13, h13, lazy_write_back_);
+	argument<14, P14>::finish (p14, h14, lazy_write_back_);
+	argument<15, P15>::finish (p15, h15, lazy_write_back_);
+}
+
+template< typename F_ >
+template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7, typename P8, typename P9, typename P10, typename P11, typename P12, typename P13, typename P14, typename P15, typename P16 >
+void typed_kernel<F_>::operator()(const device &d, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7, const P8 &p8, const P9 &p9, const P10 &p10, const P11 &p11, const P12 &p12, const P13 &p13, const P14 &p14, const P15 &p15, const P16 &p16 ) {
+	BOOST_STATIC_ASSERT(arity == 16);
+	// transfers of our parameters go into our stream, the per launch objects into one arena
+	kernel_impl::launch_scope scope (stream_);
+	kernel_impl::argument_stack stack;
+
+	typename argument<1, P1>::holder h1 = argument<1, P1>::setup (d, p1, stack);
+	typename argument<2, P2>::holder h2 = argument<2, P2>::setup (d, p2, stack);
+	typename argument<3, P3>::holder h3 = argument<3, P3>::setup (d, p3, stack);
+	typename argument<4, P4>::holder h4 = argument<4, P4>::setup (d, p4, stack);
+	typename argument<5, P5>::holder h5 = argument<5, P5>::setup (d, p5, stack);
+	typename argument<6, P6>::holder h6 = argument<6, P6>::setup (d, p6, stack);
+	typename argument<7, P7>::holder h7 = argument<7, P7>::setup (d, p7, stack);
+	typename argument<8, P8>::holder h8 = argument<8, P8>::setup (d, p8, stack);
+	typename argument<9, P9>::holder h9 = argument<9, P9>::setup (d, p9, stack);
+	typename argument<10, P10>::holder h10 = argument<10, P10>::setup (d, p10, stack);
+	typename argument<11, P11>::holder h11 = argument<11, P11>::setup (d, p11, stack);
+	typename argument<12, P12>::holder h12 = argument<12, P12>::setup (d, p12, stack);
+	typename argument<13, P13>::holder h13 = argument<13, P13>::setup (d, p13, stack);
+	typename argument<14, P14>::holder h14 = argument<14, P14>::setup (d, p14, stack);
+	typename argument<15, P15>::holder h15 = argument<15, P15>::setup (d, p15, stack);
+	typename argument<16, P16>::holder h16 = argument<16, P16>::setup (d, p16, stack);
+
+	launch(stack);
+
+	argument<1, P1>::finish (p1, h1, lazy_write_back_);
+	argument<2, P2>::finish (p2, h2, lazy_write_back_);
+	argument<3, P3>::finish (p3, h3, lazy_write_back_);
+	argument<4, P4>::finish (p4, h4, lazy_write_back_);
+	argument<5, P5>::finish (p5, h5, lazy_write_back_);
+	argument<6, P6>::finish (p6, h6, lazy_write_back_);
+	argument<7, P7>::finish (p7, h7, lazy_write_back_);
+	argument<8, P8>::finish (p8, h8, lazy_write_back_);
+	argument<9, P9>::finish (p9, h9, lazy_write_back_);
+	argument<10, P10>::finish (p10, h10, lazy_write_back_);
+	argument<11, P11>::finish (p11, h11, lazy_write_back_);
+	argument<12, P12>::finish (p12, h12, lazy_write_back_);
+	argument<13, P13>::finish (p13, h13, lazy_write_back_);
+	argument<14, P14>::finish (p14, h14, lazy_write_back_);
+	argument<15, P15>::finish (p15, h15, lazy_write_back_);
+	argument<16, P16>::finish (p16, h16, lazy_write_back_);
+}
+
+/***  OPERATPR() WITH STREAM  ***/
+template< typename F_ >
+void typed_kernel<F_>::operator()(const device &d, const stream &s) {
+	stream_switch guard (*this, s);
+	(*this)(d);
+}
+
+template< typename F_ >
+template< typename P1 >
+void typed_kernel<F_>::operator()(const device &d, const stream &s, const P1 &p1 ) {
+	stream_switch guard (*this, s);
+	(*this)(d, p1);
+}
+
+template< typename F_ >
+template< typename P1, typename P2 >
+void typed_kernel<F_>::operator()(const device &d, const stream &s, const P1 &p1, const P2 &p2 ) {
+	stream_switch guard (*this, s);
+	(*this)(d, p1, p2);
+}
+
+template< typename F_ >
+template< typename P1, typename P2, typename P3 >
+void typed_kernel<F_>::operator()(const device &d, const stream &s, const P1 &p1, const P2 &p2, const P3 &p3 ) {
+	stream_switch guard (*this, s);
+	(*this)(d, p1, p2, p3);
+}
+
+template< typename F_ >
+template< typename P1, typename P2, typename P3, typename P4 >
+void typed_kernel<F_>::operator()(const device &d, const stream &s, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4 ) {
+	stream_switch guard (*this, s);
+	(*this)(d, p1, p2, p3, p4);
+}
+
+template< typename F_ >
+template< typename P1, typename P2, typename P3, typename P4, typename P5 >
+void typed_kernel<F_>::operator()(const device &d, const stream &s, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5 ) {
+	stream_switch guard (*this, s);
+	(*this)(d, p1, p2, p3, p4, p5);
+}
+
+template< typename F_ >
+template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6 >
+void typed_kernel<F_>::operator()(const device &d, const stream &s, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6 ) {
+	stream_switch guard (*this, s);
+	(*this)(d, p1, p2, p3, p4, p5, p6);
+}
+
+template< typename F_ >
+template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7 >
+void typed_kernel<F_>::operator()(const device &d, const stream &s, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7 ) {
+	stream_switch guard (*this, s);
+	(*this)(d, p1, p2, p3, p4, p5, p6, p7);
+}
+
+template< typename F_ >
+template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7, typename P8 >
+void typed_kernel<F_>::operator()(const device &d, const stream &s, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7, const P8 &p8 ) {
+	stream_switch guard (*this, s);
+	(*this)(d, p1, p2, p3, p4, p5, p6, p7, p8);
+}
+
+template< typename F_ >
+template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7, typename P8, typename P9 >
+void typed_kernel<F_>::operator()(const device &d, const stream &s, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7, const P8 &p8, const P9 &p9 ) {
+	stream_switch guard (*this, s);
+	(*this)(d, p1, p2, p3, p4, p5, p6, p7, p8, p9);
+}
+
+template< typename F_ >
+template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7, typename P8, typename P9, typename P10 >
+void typed_kernel<F_>::operator()(const device &d, const stream &s, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7, const P8 &p8, const P9 &p9, const P10 &p10 ) {
+	stream_switch guard (*this, s);
+	(*this)(d, p1, p2, p3, p4, p5, p6, p7, p8, p9, p10);
+}
+
+template< typename F_ >
+template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7, typename P8, typename P9, typename P10, typename P11 >
+void typed_kernel<F_>::operator()(const device &d, const stream &s, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7, const P8 &p8, const P9 &p9, const P10 &p10, const P11 &p11 ) {
+	stream_switch guard (*this, s);
+	(*this)(d, p1, p2, p3, p4, p5, p6, p7, p8, p9, p10, p11);
+}
+
+template< typename F_ >
+template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7, typename P8, typename P9, typename P10, typename P11, typename P12 >
+void typed_kernel<F_>::operator()(const device &d, const stream &s, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7, const P8 &p8, const P9 &p9, const P10 &p10, const P11 &p11, const P12 &p12 ) {
+	stream_switch guard (*this, s);
+	(*this)(d, p1, p2, p3, p4, p5, p6, p7, p8, p9, p10, p11, p12);
+}
+
+template< typename F_ >
+template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7, typename P8, typename P9, typename P10, typename P11, typename P12, typename P13 >
+void typed_kernel<F_>::operator()(const device &d, const stream &s, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7, const P8 &p8, const P9 &p9, const P10 &p10, const P11 &p11, const P12 &p12, const P13 &p13 ) {
+	stream_switch guard (*this, s);
+	(*this)(d, p1, p2, p3, p4, p5, p6, p7, p8, p9, p10, p11, p12, p13);
+}
+
+template< typename F_ >
+template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7, typename P8, typename P9, typename P10, typename P11, typename P12, typename P13, typename P14 >
+void typed_kernel<F_>::operator()(const device &d, const stream &s, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7, const P8 &p8, const P9 &p9, const P10 &p10, const P11 &p11, const P12 &p12, const P13 &p13, const P14 &p14 ) {
+	stream_switch guard (*this, s);
+	(*this)(d, p1, p2, p3, p4, p5, p6, p7, p8, p9, p10, p11, p12, p13, p14);
+}
+
+template< typename F_ >
+template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7, typename P8, typename P9, typename P10, typename P11, typename P12, typename P13, typename P14, typename P15 >
+void typed_kernel<F_>::operator()(const device &d, const stream &s, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7, const P8 &p8, const P9 &p9, const P10 &p10, const P11 &p11, const P12 &p12, const P13 &p13, const P14 &p14, const P15 &p15 ) {
+	stream_switch guard (*this, s);
+	(*this)(d, p1, p2, p3, p4, p5, p6, p7, p8, p9, p10, p11, p12, p13, p14, p15);
+}
+
+template< typename F_ >
+template< typename P1, typename P2, typename P3, typename P4, typename P5, typename P6, typename P7, typename P8, typename P9, typename P10, typename P11, typename P12, typename P13, typename P14, typename P15, typename P16 >
+void typed_kernel<F_>::operator()(const device &d, const stream &s, const P1 &p1, const P2 &p2, const P3 &p3, const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7, const P8 &p8, const P9 &p9, const P10 &p10, const P11 &p11, const P12 &p12, const P13 &p13, const P14 &p14, const P15 &p15, const P16 &p16 ) {
+	stream_switch guard (*this, s);
+	(*this)(d, p1, p2, p3, p4, p5, p6, p7, p8, p9, p10, p11, p12, p13, p14, p15, p16);
+}
+
+} // cupp
+
+#endif //CUPP_typed_kernel_H
@@ -17,6 +17,12 @@
 #include "cupp/kernel_call_traits.h"
 #include "cupp/device.h"
 #include "cupp/memory1d.h"
+#include "cupp/stream.h"
+#include "cupp/completion.h"
+#include "cupp/dirty_ranges.h"
+#include "cupp/access.h"
+#include "cupp/spill_registry.h"
+#include "cupp/tracer.h"
 
 #include "cupp/deviceT/vector.h"
 
@@ -25,9 +31,14 @@
 
 // STD
 #include <cstddef> // Include std::size_t
-#include <algorithm> // Include std::swap
+#include <cstring> // Include std::memcpy
+#include <algorithm> // Include std::swap, std::min, std::fill
+#include <map>
 #include <vector>
 
+// BOOST
+#include <boost/type_traits.hpp>
+
 // CUDA
 #include <cuda_runtime.h>
 
@@ -36,6 +47,10 @@ namespace cupp {
 // Just used to force the user to configure and get a device.
 class device;
 
+namespace impl {
+template <typename T> class chunk_tile;
+}
+
 
 /**
  * @class vector
@@ -44,12 +59,25 @@ class device;
  * @date 24.08.2007
  * @platform Host only
  * @brief A std::vector wrapper, which can be transfered to the device incl. lazy memory copying.
+ *
+ * The elements changed on the host are tracked (see @c impl::dirty_ranges), so only they are transfered
+ * to the device by the next kernel call. If most of the elements have been changed, the whole vector is transfered.
+ * After a kernel changed the vector, accessing single elements only transfers the pages containing them back to the host.
+ * When used on several devices, the vector keeps a copy of its data on each of them. A device only receives the elements
+ * changed since it has been used last, or a copy from the device used before, if the devices have peer access.
+ * If a device runs out of memory, the copies of the least recently used vectors, whose host data is up to date, are freed
+ * (see @c spill_registry) and transfered again by the next kernel call using them.
  */
 
 template< typename T >
-class vector {
+class vector : private spillable {
 	private:
 		typedef typename get_type<T>::device_type                T_device_type;
+
+		/**
+		 * true_type if our elements can be transfered without a temporary copy
+		 */
+		typedef boost::integral_constant<bool, is_bitwise_transferable<T>::value> bitwise_transfer;
 		
 	public: /*** TYPEDEFS  ***/
 		typedef deviceT::vector< T_device_type >                 device_type;
@@ -82,39 +110,46 @@ class vector {
 
 			public: /***  Operators  ***/
 				operator T&() const {
-					vector_.update_host();
+					impl::trace_trigger trigger ("proxy");
+					vector_.update_host(at_, at_+1);
 					return vector_.data_[at_];
 				}
 				
 				const T& get() const {
-					vector_.update_host();
+					impl::trace_trigger trigger ("proxy");
+					vector_.update_host(at_, at_+1);
 					return vector_.data_[at_];
 				}
 				
 				T& get() {
-					vector_.update_host();
-					vector_.host_changes_ = true;
+					impl::trace_trigger trigger ("proxy");
+					vector_.update_host(at_, at_+1);
+					vector_.host_changes_.mark(at_);
 					return vector_.data_[at_];
 				}
 				
 				element_proxy& operator=(const element_proxy &rhs) {
-					rhs.vector_.update_host();
-					vector_.update_host();
-					vector_.host_changes_ = true;
+					impl::trace_trigger trigger ("proxy");
+					rhs.vector_.update_host(rhs.at_, rhs.at_+1);
+					vector_.update_host(at_, at_+1);
+					vector_.host_changes_.mark(at_);
 					vector_.data_[at_]=rhs.vector_.data_[ rhs.at_];
 					return *this;
 				}
 				
 				
 				element_proxy& operator=(const T& rhs) {
-					vector_.update_host();
-					vector_.host_changes_ = true;
+					impl::trace_trigger trigger ("proxy");
+					vector_.update_host(at_, at_+1);
+					vector_.host_changes_.mark(at_);
 					vector_.data_[at_] = rhs;
 					return *this;
 				}
 
 				T* operator&() {
-					vector_.update_host();
+					impl::trace_trigger trigger ("proxy");
+					vector_.update_host(at_, at_+1);
+					vector_.host_changes_.mark(at_);
 					return &vector_.data_[at_];
 				}
 		};
@@ -138,35 +173,42 @@ class vector {
 
 			public: /***  Operators  ***/
 				operator typename std::vector<T>::iterator() const {
+					impl::trace_trigger trigger ("iterator");
 					vector_.update_host();
-					vector_.host_changes_ = true;
+					// we don't know what is done with the std iterator, so everything behind it may change
+					vector_.host_changes_.mark(index(), vector_.data_.size());
 					return i_;
 				}
 
 				operator const_iterator() const {
+					impl::trace_trigger trigger ("iterator");
 					vector_.update_host();
 					return static_cast< const_iterator > (i_);
 				}
 
 				const T& operator* () const {
-					vector_.update_host();
+					impl::trace_trigger trigger ("iterator");
+					vector_.update_host(index(), index()+1);
 					return *i_;
 				}
 				
 				T& operator* () {
-					vector_.update_host();
-					vector_.host_changes_ = true;
+					impl::trace_trigger trigger ("iterator");
+					vector_.update_host(index(), index()+1);
+					vector_.host_changes_.mark(index());
 					return *i_;
 				}
 				
 				const T& operator-> () const {
-					vector_.update_host();
+					impl::trace_trigger trigger ("iterator");
+					vector_.update_host(index(), index()+1);
 					return *i_;
 				}
 				
 				T& operator-> () {
-					vector_.update_host();
-					vector_.host_changes_ = true;
+					impl::trace_trigger trigger ("iterator");
+					vector_.update_host(index(), index()+1);
+					vector_.host_changes_.mark(index());
 					return *i_;
 				}
 
@@ -201,42 +243,143 @@ class vector {
 				bool operator== (const iterator &other) {
 					return i_ == other.i_;
 				}
+
+			private:
+				size_type index() const {
+					return i_ - vector_.data_.begin();
+				}
 		};
 		
 		typedef          std::reverse_iterator<iterator>         reverse_iterator;
 
+
+	public: /***  Bulk host access  ***/
+
+		/**
+		 * @class host_view
+		 * @brief Read-only access to the elements [begin, end) of a @c cupp::vector through plain pointers.
+		 *        The host data is updated once when the view is created, the accesses are not checked.
+		 * @warning The view becomes invalid, if the vector is changed or passed to a kernel by non-const reference.
+		 * @example cupp::vector<int>::host_view view (v); std::accumulate (view.begin(), view.end(), 0);
+		 */
+		class host_view {
+			public: /***  Constructors & Destructors  ***/
+				explicit host_view(const vector<T>& vector) :
+					begin_(vector.size() == 0 ? 0 : &vector.data_[0]), size_(vector.size())
+				{
+					impl::trace_trigger trigger ("host view");
+					vector.update_host();
+				}
+
+				host_view(const vector<T>& vector, const size_type begin, const size_type end) :
+					begin_(end <= begin ? 0 : &vector.data_[begin]), size_(end <= begin ? 0 : end - begin)
+				{
+					impl::trace_trigger trigger ("host view");
+					vector.update_host(begin, end);
+				}
+
+			public: /***  Access  ***/
+				const T* begin() const { return begin_; }
+				const T* end() const { return begin_ + size_; }
+				const T* data() const { return begin_; }
+				size_type size() const { return size_; }
+				const T& operator[](const size_type index) const { return begin_[index]; }
+
+			private: /***  Data elements  ***/
+				const T* begin_;
+				size_type size_;
+		};
+
+		/**
+		 * @class host_span
+		 * @brief Read-write access to the elements [begin, end) of a @c cupp::vector through plain pointers.
+		 *        The host data is updated once when the span is created, all its elements are marked as changed
+		 *        once it is destroyed.
+		 * @warning The span must be destroyed before the vector is passed to a kernel, otherwise the changes are not transfered.
+		 *          It becomes invalid, if the size of the vector is changed.
+		 * @example { cupp::vector<int>::host_span span (v); std::fill (span.begin(), span.end(), 0); } k (d, v);
+		 */
+		class host_span {
+			public: /***  Constructors & Destructors  ***/
+				explicit host_span(vector<T>& vector) :
+					vector_(vector), begin_(vector.size() == 0 ? 0 : &vector.data_[0]), offset_(0), size_(vector.size())
+				{
+					impl::trace_trigger trigger ("host view");
+					vector_.update_host();
+				}
+
+				host_span(vector<T>& vector, const size_type begin, const size_type end) :
+					vector_(vector), begin_(end <= begin ? 0 : &vector.data_[begin]), offset_(begin), size_(end <= begin ? 0 : end - begin)
+				{
+					impl::trace_trigger trigger ("host view");
+					vector_.update_host(begin, end);
+				}
+
+				~host_span() {
+					vector_.host_changes_.mark (offset_, offset_ + size_);
+				}
+
+			public: /***  Access  ***/
+				T* begin() const { return begin_; }
+				T* end() const { return begin_ + size_; }
+				T* data() const { return begin_; }
+				size_type size() const { return size_; }
+				T& operator[](const size_type index) const { return begin_[index]; }
+
+			private: /***  Data elements  ***/
+				vector<T>& vector_;
+				T* begin_;
+				const size_type offset_;
+				const size_type size_;
+		};
+
 	public: /***  CONSTRUCTORS AND DESTRUCTORS  ***/
 	
 		/**
 		 * @see @c std::vector
 		 */
-		vector() : data_(), host_changes_(true), device_changes_(false), ref_invalid_(true), memory_ptr_(0), device_ref_ptr_(0) {}
+		vector() : data_(), host_changes_(true), device_changes_(false), missing_pages_(0), ref_invalid_(true), ref_outdated_(false), memory_ptr_(0), device_size_(0), device_ref_ptr_(0), device_prefetching_(false), host_prefetching_(false), prefetch_staging_(0), device_only_(false) {}
 
 		/**
 		 * @see @c std::vector
 		 */
-		vector( const vector& c ) : host_changes_(true), device_changes_(false), ref_invalid_(true), memory_ptr_(0), device_ref_ptr_(0) {
-			c.update_host();
-			data_ = c.data_;
+		vector( const vector& c ) : host_changes_(true), device_changes_(false), missing_pages_(0), ref_invalid_(true), ref_outdated_(false), memory_ptr_(0), device_size_(0), device_ref_ptr_(0), device_prefetching_(false), host_prefetching_(false), prefetch_staging_(0), device_only_(false) {
+			copy_from (c);
 		}
 
+#if __cplusplus >= 201103L
+		/**
+		 * @brief Takes over the host and device data of @a c, nothing is copied
+		 */
+		vector( vector&& c ) : host_changes_(true), device_changes_(false), missing_pages_(0), ref_invalid_(true), ref_outdated_(false), memory_ptr_(0), device_size_(0), device_ref_ptr_(0), device_prefetching_(false), host_prefetching_(false), prefetch_staging_(0), device_only_(false) {
+			swap (c);
+		}
+#endif
+
 		/**
 		 * @see @c std::vector
 		 */
-		vector( size_type num, const T& val = T() ) : data_(num, val), host_changes_(true), device_changes_(false), ref_invalid_(true), memory_ptr_(0), device_ref_ptr_(0) {}
+		vector( size_type num, const T& val = T() ) : data_(num, val), host_changes_(true), device_changes_(false), missing_pages_(0), ref_invalid_(true), ref_outdated_(false), memory_ptr_(0), device_size_(0), device_ref_ptr_(0), device_prefetching_(false), host_prefetching_(false), prefetch_staging_(0), device_only_(false) {}
 
 		/**
 		 * @see @c std::vector
 		 */
 		template <typename input_iterator>
-		vector( input_iterator start, input_iterator end ) : data_(start, end), host_changes_(true), device_changes_(false), ref_invalid_(true), memory_ptr_(0), device_ref_ptr_(0) {}
+		vector( input_iterator start, input_iterator end ) : data_(start, end), host_changes_(true), device_changes_(false), missing_pages_(0), ref_invalid_(true), ref_outdated_(false), memory_ptr_(0), device_size_(0), device_ref_ptr_(0), device_prefetching_(false), host_prefetching_(false), prefetch_staging_(0), device_only_(false) {}
 
 		/**
 		 * @see @c std::vector
 		 */
 		~vector() {
+			spill_registry::instance().remove(this);
+
+			// the transfer must not write into memory given back
+			host_prefetch_.wait();
+			release_prefetch_staging();
+
 			delete memory_ptr_;
 			delete device_ref_ptr_;
+			drop_replicas();
 		}
 
 
@@ -252,7 +395,7 @@ class vector {
 		 * @see @c std::vector
 		 */
 		const T& operator[]( size_type index ) const {
-			update_host();
+			update_host(index, index+1);
 			return data_[index];
 		}
 
@@ -260,15 +403,22 @@ class vector {
 		 * @see @c std::vector
 		 */
 		vector& operator=(const vector& c2) {
-			c2.update_host();
-			data_ = c2.data_;
-			host_changes_ = true;
+			if (this != &c2) {
+				copy_from (c2);
+			}
 
-			// our data have been overwritten ... ignore all old data on the device
-			device_changes_ = false;
+			return *this;
+		}
 
+#if __cplusplus >= 201103L
+		/**
+		 * @brief Takes over the host and device data of @a c2, nothing is copied
+		 */
+		vector& operator=(vector&& c2) {
+			swap (c2);
 			return *this;
 		}
+#endif
 
 	public: /***  NORMAL FUNCTIONS  ***/
 		/**
@@ -277,7 +427,7 @@ class vector {
 		void assign( size_type num, const T& val ) {
 			data_.assign (num, val);
 			
-			host_changes_ = true;
+			host_changes_.mark_all();
 			// our data have been overwritten ... ignore all old data on the device
 			device_changes_ = false;
 		}
@@ -289,7 +439,7 @@ class vector {
 		void assign( input_iterator start, input_iterator end ) {
 			data_.assign (start, end);
 			
-			host_changes_ = true;
+			host_changes_.mark_all();
 			// our data have been overwritten ... ignore all old data on the device
 			device_changes_ = false;
 		}
@@ -306,7 +456,7 @@ class vector {
 		 * @see @c std::vector
 		 */
 		const T& at( size_type loc ) const {
-			update_host();
+			update_host(loc, loc+1);
 			return data_.at(loc);
 		}
 		
@@ -321,7 +471,7 @@ class vector {
 		 * @see @c std::vector
 		 */
 		const T& back() const {
-			update_host();
+			update_host(data_.size()-1, data_.size());
 			return data_.back();
 		}
 
@@ -337,6 +487,7 @@ class vector {
 		 * @see @c std::vector
 		 */
 		const_iterator begin() const {
+			update_host();
 			return data_.begin();
 		}
 
@@ -347,12 +498,97 @@ class vector {
 			return data_.capacity();
 		}
 
+		/**
+		 * @return The number of elements, which fit into the memory allocated on the device
+		 */
+		size_type device_capacity() const {
+			return memory_ptr_ == 0 ? 0 : memory_ptr_ -> size();
+		}
+
+		/**
+		 * @brief Frees the memory not needed by our elements, on the host and on the device.
+		 *        The memory on the device is allocated again with the next kernel call.
+		 */
+		void shrink_to_fit() {
+			update_host();
+
+			std::vector<T>(data_).swap(data_);
+
+			if (memory_ptr_ != 0 && memory_ptr_ -> size() != data_.size()) {
+				delete memory_ptr_;
+				memory_ptr_ = 0;
+				host_changes_.mark_all();
+			}
+
+			drop_replicas();
+		}
+
+		/**
+		 * @brief Starts the transfer of our data to device @a d in stream @a s, so the next kernel call using us on @a d
+		 *        has nothing to transfer. A kernel called in another stream waits for the transfer on the device.
+		 * @return The completion of the transfer
+		 * @note Our host data may be changed right away, the changes are transfered by the next kernel call.
+		 */
+		completion prefetch(const device &d, const stream &s = stream()) {
+			impl::trace_trigger trigger ("prefetch");
+			impl::stream_guard guard (s);
+			update_device (d);
+
+			device_prefetch_ = completion (s.get());
+			device_prefetching_ = true;
+			return device_prefetch_;
+		}
+
+		/**
+		 * @brief Starts the transfer of the data changed by a kernel back to the host in the stream of that kernel.
+		 *        The next access to our elements only waits for the transfer to finish.
+		 * @return The completion of the transfer
+		 */
+		completion prefetch_to_host() const {
+			return prefetch_to_host (stream_);
+		}
+
+		/**
+		 * @brief Starts the transfer of the data changed by a kernel back to the host in stream @a s.
+		 *        The next access to our elements only waits for the transfer to finish.
+		 *        The data is copied through a page-locked buffer of the @c staging_pool.
+		 * @return The completion of the transfer
+		 */
+		completion prefetch_to_host(const stream &s) const {
+			if (!device_changes_ || host_prefetching_ || device_size_ == 0) {
+				return host_prefetch_;
+			}
+
+			impl::trace_trigger trigger ("prefetch");
+
+			// the transfer must not overtake the kernel, which changed our data
+			impl::wait_for_stream (s, stream_.get());
+			memory_ptr_ -> use_in (s);
+
+			// the data stays in the staging buffer, finish_prefetch_to_host() takes the missing pages from there
+			staging_pool &pool = staging_pool::instance();
+			const std::size_t size_in_b = device_size_ * sizeof(T_device_type);
+			impl::trace_scope trace ("transfer", "vector::prefetch_to_host", size_in_b);
+
+			prefetch_staging_ = pool.acquire (size_in_b);
+			if (cudaMemcpyAsync (prefetch_staging_, memory_ptr_ -> cuda_pointer().get(), size_in_b, cudaMemcpyDeviceToHost, s.get()) != cudaSuccess) {
+				pool.release (prefetch_staging_);
+				prefetch_staging_ = 0;
+				throw exception::cuda_runtime_error(cudaGetLastError());
+			}
+			pool.count_pinned (0, size_in_b);
+
+			host_prefetch_ = completion (s.get());
+			host_prefetching_ = true;
+			return host_prefetch_;
+		}
+
 		/**
 		 * @see @c std::vector
 		 */
 		void clear() {
 			data_.clear();
-			host_changes_ = true;
+			host_changes_.mark_all();
 			device_changes_ = false;
 		}
 
@@ -384,8 +620,10 @@ class vector {
 		 */
 		iterator erase( iterator loc ) {
 			update_host();
-			host_changes_ = true;
-			return iterator (data_.erase(loc), *this);
+			const typename std::vector<T>::iterator returnee = data_.erase(loc);
+			// all elements behind loc moved
+			host_changes_.mark(returnee - data_.begin(), data_.size());
+			return iterator (returnee, *this);
 		}
 		
 		/**
@@ -393,8 +631,10 @@ class vector {
 		 */
 		iterator erase( iterator start, iterator end ) {
 			update_host();
-			host_changes_ = true;
-			return iterator (data_.erase(start, end), *this);
+			const typename std::vector<T>::iterator returnee = data_.erase(start, end);
+			// all elements behind start moved
+			host_changes_.mark(returnee - data_.begin(), data_.size());
+			return iterator (returnee, *this);
 		}
 		
 		/**
@@ -408,7 +648,7 @@ class vector {
 		 * @see @c std::vector
 		 */
 		const T& front() const {
-			update_host();
+			update_host(0, 1);
 			return data_.front();
 		}
 
@@ -417,8 +657,10 @@ class vector {
 		 */
 		iterator insert( iterator loc, const T& val ) {
 			update_host();
-			host_changes_ = true;
-			return iterator (data_.insert(loc, val), *this);
+			const typename std::vector<T>::iterator returnee = data_.insert(loc, val);
+			// all elements behind loc moved
+			host_changes_.mark(returnee - data_.begin(), data_.size());
+			return iterator (returnee, *this);
 		}
 		
 		/**
@@ -426,8 +668,10 @@ class vector {
 		 */
 		void insert( iterator loc, size_type num, const T& val ) {
 			update_host();
-			host_changes_ = true;
-			data_.insert(loc, num, val);
+			const size_type pos = static_cast<typename std::vector<T>::iterator>(loc) - data_.begin();
+			data_.insert(data_.begin() + pos, num, val);
+			// all elements behind loc moved
+			host_changes_.mark(pos, data_.size());
 		}
 
 		/**
@@ -436,8 +680,10 @@ class vector {
 		template <typename input_iterator>
 		void insert( iterator loc, input_iterator start, input_iterator end ) {
 			update_host();
-			host_changes_ = true;
-			data_.insert(loc, start, end);
+			const size_type pos = static_cast<typename std::vector<T>::iterator>(loc) - data_.begin();
+			data_.insert(data_.begin() + pos, start, end);
+			// all elements behind loc moved
+			host_changes_.mark(pos, data_.size());
 		}
 
 		/**
@@ -453,7 +699,7 @@ class vector {
 		void pop_back() {
 			update_host();
 			data_.pop_back();
-			host_changes_ = true;
+			// the size is updated by the next transfer, no element changed
 		}
 
 		/**
@@ -462,7 +708,7 @@ class vector {
 		void push_back( const T& val ) {
 			update_host();
 			data_.push_back(val);
-			host_changes_ = true;
+			host_changes_.mark(data_.size()-1);
 		}
 
 		/**
@@ -470,7 +716,7 @@ class vector {
 		 */
 		reverse_iterator rbegin() {
 			update_host();
-			host_changes_ = true;
+			host_changes_.mark_all();
 			return data_.rbegin();
 		}
 
@@ -487,7 +733,7 @@ class vector {
 		 */
 		reverse_iterator rend() {
 			update_host();
-			host_changes_ = true;
+			host_changes_.mark_all();
 			return data_.rend();
 		}
 		
@@ -511,8 +757,9 @@ class vector {
 		 */
 		void resize( size_type num, const T& val = T() ) {
 			update_host();
+			const size_type old_size = data_.size();
 			data_.resize (num, val);
-			host_changes_ = true;
+			host_changes_.mark(old_size, data_.size());
 		}
 
 		/**
@@ -526,13 +773,33 @@ class vector {
 		 * @see @c std::vector
 		 */
 		void swap( vector<T>& from ) {
-			update_host();
-			
-			from.update_host();
-			data_.swap(from.data);
-			
-			host_changes_ = true;
-			from.host_changes_ = true;
+			// our device data goes with our host data, so nothing has to be transfered
+			data_.swap(from.data_);
+			host_changes_.swap(from.host_changes_);
+			std::swap(device_changes_, from.device_changes_);
+			resident_.swap(from.resident_);
+			std::swap(missing_pages_, from.missing_pages_);
+			std::swap(ref_invalid_, from.ref_invalid_);
+			std::swap(ref_outdated_, from.ref_outdated_);
+			std::swap(memory_ptr_, from.memory_ptr_);
+			std::swap(device_size_, from.device_size_);
+			std::swap(device_ref_ptr_, from.device_ref_ptr_);
+			std::swap(device_id_, from.device_id_);
+			replicas_.swap(from.replicas_);
+			std::swap(stream_, from.stream_);
+			uploads_.swap(from.uploads_);
+			std::swap(device_prefetch_, from.device_prefetch_);
+			std::swap(device_prefetching_, from.device_prefetching_);
+			std::swap(host_prefetch_, from.host_prefetch_);
+			std::swap(host_prefetching_, from.host_prefetching_);
+			std::swap(prefetch_staging_, from.prefetch_staging_);
+			std::swap(device_only_, from.device_only_);
+
+			// the registry has to know on which devices our memory is now
+			spill_registry::instance().remove(this);
+			spill_registry::instance().remove(&from);
+			register_device_memory();
+			from.register_device_memory();
 		}
 
 	public: /*** CuPP kernel call traits implementation ***/
@@ -544,7 +811,7 @@ class vector {
 			update_device(d);
 
 			device_type temp;
-			temp.set_size ( size());
+			temp.set_size (device_size_);
 			temp.set_device_pointer (memory_ptr_->cuda_pointer().get());
 			return temp;
 		}
@@ -563,9 +830,16 @@ class vector {
 				device_ref_ptr_ = new device_reference<device_type> (d, transform(d));
 				
 				ref_invalid_ = false;
+				ref_outdated_ = false;
+			} else if (ref_outdated_) {
+				// only our size changed, the proxy is updated in place
+				device_ref_ptr_ -> set (transform(d));
+
+				ref_outdated_ = false;
 			}
 
 			assert (device_ref_ptr_!=0);
+			device_ref_ptr_ -> use_in (impl::current_stream());
 
 			return *device_ref_ptr_;
 		}
@@ -576,7 +850,8 @@ class vector {
 		void dirty (device_reference< device_type > device_copy) {
 			UNUSED_PARAMETER(device_copy);
 			
-			device_changes_ = true;
+			device_changed();
+			stream_ = impl::current_stream();
 		}
 
 		/*void update (const device_type &value) {
@@ -588,7 +863,7 @@ class vector {
 		vector< T >&  operator= (const device_type& value) {
 			UNUSED_PARAMETER(value);
 			
-			device_changes_ = true;
+			device_changed();
 			return *this;
 		}
 
@@ -596,84 +871,631 @@ class vector {
 		 * If there is newer data on the device, this function will update the host data with it
 		 */
 		void update_host() const {
-			if (device_changes_) {
-				assert(!host_changes_);
-				assert(memory_ptr_!=0);
+			update_host(0, data_.size());
+		}
 
-				std::vector< T_device_type > temp( data_.size() );
-				
-				memory_ptr_ -> copy_to_host (&temp[0]);
+		/**
+		 * If there is newer data on the device, this function will update the host data of the
+		 * elements [@a begin, @a end) with it. The data is transfered in pages of @c download_page_size bytes,
+		 * pages already on the host are not transfered again.
+		 */
+		void update_host(const size_type begin, const size_type end) const {
+			finish_prefetch_to_host();
 
-				for (std::size_t i = 0; i<temp.size(); ++i) {
-					data_[i] = temp[i];
+			if (!device_changes_) {
+				return;
+			}
+
+			impl::trace_trigger trigger ("host access");
+			impl::trace_scope trace ("update", "vector::update_host");
+
+			assert(memory_ptr_!=0);
+
+			const size_type per_page = elements_per_page();
+			const size_type first = begin / per_page;
+			const size_type last  = (std::min(end, data_.size()) + per_page - 1) / per_page;
+
+			// every run of missing pages is downloaded with one copy
+			for (size_type page = first; page < last; ) {
+				if (resident_[page]) {
+					++page;
+					continue;
 				}
-				
-				
+
+				size_type run_end = page + 1;
+				while (run_end < last && !resident_[run_end]) {
+					++run_end;
+				}
+
+				download (page * per_page, std::min(run_end * per_page, data_.size()));
+
+				std::fill (resident_.begin() + page, resident_.begin() + run_end, true);
+				missing_pages_ -= run_end - page;
+				page = run_end;
+			}
+
+			if (missing_pages_ == 0) {
 				device_changes_ = false;
 			}
 		}
 
 		/**
-		 * If there is newer data on the host, this function will update the device data with it
+		 * If there is newer data on the host, this function will update the device data with it.
+		 * Only the changed elements are transfered, unless most of them have been changed.
+		 * The memory on the device grows geometrically, so a growing vector is not reallocated with every kernel call.
 		 */
 		void update_device(const device &d) {
-			// changes on the host side or we are executed on a new device
-			if (host_changes_ || d.id() != device_id_) {
+			// our memory1d and replicas are counted as vector memory
+			impl::allocation_tag tag ("vector");
+
+			// a tile of for_each_chunk() has no host data, it sets up our memory by resize_device_only()
+			if (device_only_) {
+				memory_ptr_ -> use_in (impl::current_stream());
+				return;
+			}
+
+			// we are the most recently used vector on d now
+			spill_registry::instance().touch(this, d.id());
 
-				std::vector< T_device_type > temp;
-				/// @todo use a std algo
-				for (typename std::vector< T >::iterator it = data_.begin(); it != data_.end(); ++it) {
-					temp.push_back ( kernel_call_traits< T, T_device_type >::transform (d, *it) );
+			// a kernel in another stream must not start before our prefetched data has arrived
+			if (device_prefetching_) {
+				device_prefetching_ = false;
+				if (impl::current_stream().get() != stream_.get()) {
+					device_prefetch_.wait_in (impl::current_stream().get());
 				}
-				
-				// we don't have any space on the device, or the we have more/less space on the device than we neeed
-				// or we are executed on a new device
-				if (memory_ptr_ == 0 || memory_ptr_ -> size()!=data_.size() || d.id() != device_id_) {
-					// free the memory
-					delete memory_ptr_;
-					
-					// get new memory and copy the data
-					memory_ptr_ = new memory1d<T_device_type>(d, &temp[0], temp.size() );
+			}
+
+			// the changes on the host are missing on our other replicas, too
+			for (typename replica_map::iterator it = replicas_.begin(); it != replicas_.end(); ++it) {
+				it->second.pending.mark (host_changes_);
+			}
 
-					// we need to create a new proxy because our memory has a new address
-					ref_invalid_ = true;
-				} else {
-					// copy the data to the device
-					memory_ptr_ -> copy_to_device (&temp[0]);
+			// the kernel overwrites us, so our data is not needed on the device
+			const bool overwritten = impl::take_access() == write_only;
+
+			// we have been used on another device the last time (our memory there may have been spilled)
+			if ((memory_ptr_ != 0 || !replicas_.empty()) && d.id() != device_id_) {
+				switch_device (d, overwritten);
+			}
+
+			if (overwritten) {
+				host_changes_.clear();
+			}
+
+			// we don't have enough space on the device or we are executed on a new device
+			const bool new_memory = memory_ptr_ == 0 || memory_ptr_ -> size() < data_.size() || d.id() != device_id_;
+
+			if (!new_memory && host_changes_.empty() && device_size_ == data_.size()) {
+				// the kernel reads our memory in its stream
+				memory_ptr_ -> use_in (impl::current_stream());
+				return;
+			}
+
+			impl::trace_scope trace ("update", "vector::update_device");
+
+			// a full upload needs all data on the host
+			const bool full_upload = !overwritten && (new_memory || host_changes_.mostly_dirty(data_.size()));
+			if (full_upload) {
+				update_host();
+			}
+
+			if (new_memory) {
+				// grow geometrically, as long as we stay on the same device
+				size_type capacity = data_.size();
+				if (memory_ptr_ != 0 && d.id() == device_id_) {
+					capacity = std::max (capacity, 2 * memory_ptr_ -> size());
 				}
 
-				device_id_ = d.id();
-				host_changes_ = false;
+				// free the memory
+				delete memory_ptr_;
+				memory_ptr_ = 0;
+
+				// get new memory
+				memory_ptr_ = new memory1d<T_device_type>(d, capacity );
+
+				// we need to create a new proxy because our memory has a new address
+				ref_invalid_ = true;
+			} else if (device_size_ != data_.size()) {
+				// same memory, only the size stored in the proxy is out of date
+				ref_outdated_ = true;
+			}
+
+			// copy the data to the device, in the stream of the current kernel call
+			stream_ = impl::current_stream();
+			memory_ptr_ -> use_in (stream_);
+			uploads_.clear();
+
+			if (full_upload) {
+				upload (d, 0, data_.size());
+			} else {
+				for (impl::dirty_ranges::const_iterator it = host_changes_.begin(); it != host_changes_.end(); ++it) {
+					// elements behind the end may have been removed since they were marked
+					upload (d, it->first, std::min(it->second, data_.size()));
+				}
+			}
+
+			device_id_ = d.id();
+			device_size_ = data_.size();
+			host_changes_.clear();
+		}
+
+	private:
+		enum {
+			/**
+			 * The granularity in which data is transfered from the device by @c update_host()
+			 */
+			download_page_size = 64 * 1024
+		};
+
+		static size_type elements_per_page() {
+			return std::max<size_type> (1, download_page_size / sizeof(T_device_type));
+		}
+
+		/**
+		 * Marks all our data on the device as newer than the data on the host and on the other devices
+		 */
+		void device_changed() {
+			// the kernel may have changed the data being prefetched
+			finish_prefetch_to_host();
+
+			const size_type pages = (data_.size() + elements_per_page() - 1) / elements_per_page();
+
+			device_changes_ = true;
+			resident_.assign (pages, false);
+			missing_pages_ = pages;
+
+			for (typename replica_map::iterator it = replicas_.begin(); it != replicas_.end(); ++it) {
+				it->second.pending.mark_all();
+			}
+		}
+
+		/**
+		 * Makes our memory on the device @a d hold @a count elements without any data on the host. Only used by
+		 * a tile of for_each_chunk(), which transfers its chunks to our memory itself. The memory is only
+		 * allocated again, if it is too small. We are not known to the @c spill_registry, as our data can not be
+		 * transfered again from the host.
+		 */
+		void resize_device_only (const device &d, const size_type count) {
+			impl::allocation_tag tag ("vector");
+
+			device_only_ = true;
+
+			if (memory_ptr_ == 0 || memory_ptr_ -> size() < count || d.id() != device_id_) {
+				delete memory_ptr_;
+				memory_ptr_ = 0;
+
+				memory_ptr_ = new memory1d<T_device_type>(d, count);
+				ref_invalid_ = true;
+			} else if (device_size_ != count) {
+				ref_outdated_ = true;
+			}
+
+			memory_ptr_ -> use_in (impl::current_stream());
+			device_size_ = count;
+			device_id_ = d.id();
+		}
+
+		/**
+		 * Puts the replica of the device we have been used on last aside and makes the one of @a d the current one.
+		 * If most of its data is out of date and the devices have peer access, it is copied from the current replica.
+		 * Nothing is transfered, if the kernel overwrites us (@a overwritten).
+		 */
+		void switch_device(const device &d, const bool overwritten) {
+			const device::id_t target = d.id();
+
+			replica next;
+			typename replica_map::iterator it = replicas_.find(target);
+			if (it != replicas_.end()) {
+				next = it->second;
+				replicas_.erase(it);
+			}
+
+			bool peer_copy = false;
+#if CUDART_VERSION >= 4000
+			peer_copy = !overwritten && next.pending.mostly_dirty(data_.size()) && device_size_ != 0 && peer_access (device_id_);
+#endif
+
+			if (peer_copy) {
+#if CUDART_VERSION >= 4000
+				if (next.memory == 0 || next.memory -> size() < device_size_) {
+					delete next.memory;
+					next.memory = new memory1d<T_device_type>(d, memory_ptr_ -> size() );
+					next.ref_invalid = true;
+				}
+
+				// the last kernel call and uploads on the old device run in another stream, the copy must not overtake
+				// them. The copy is ordered before the next kernel call.
+				impl::wait_for_stream (impl::current_stream(), stream_.get(), device_id_);
+				stream_ = impl::current_stream();
+				memory_ptr_ -> use_in (stream_);
+				next.memory -> use_in (stream_);
+				copy_peer_async (next.memory -> cuda_pointer().get(), target, memory_ptr_ -> cuda_pointer().get(), device_id_, device_size_, stream_.get());
+
+				next.ref_outdated = next.size != device_size_;
+				next.size = device_size_;
+
+				// the replica is a copy of the current one now, so it misses what the current one misses
+				next.pending = host_changes_;
+#endif
+			} else if (!overwritten) {
+				// the replica is updated from the host
+				update_host();
+			}
+
+			// put the current replica aside
+			replica &current = replicas_[device_id_];
+			current.memory       = memory_ptr_;
+			current.size         = device_size_;
+			current.ref          = device_ref_ptr_;
+			current.ref_invalid  = ref_invalid_;
+			current.ref_outdated = ref_outdated_;
+			current.pending      = host_changes_;
+
+			memory_ptr_     = next.memory;
+			device_size_    = next.size;
+			device_ref_ptr_ = next.ref;
+			ref_invalid_    = next.ref_invalid;
+			ref_outdated_   = next.ref_outdated;
+			host_changes_   = next.pending;
+			device_id_      = target;
+		}
+
+		/**
+		 * Makes us a copy of @a c. If the data of @a c on the device is newer than on the host, it is copied on the device.
+		 */
+		void copy_from (const vector &c) {
+			impl::allocation_tag tag ("vector");
+
+			finish_prefetch_to_host();
+
+			if (c.memory_ptr_ == 0 || !c.device_changes_) {
+				c.update_host();
+				data_ = c.data_;
+				host_changes_.mark_all();
+
+				// our data have been overwritten ... ignore all old data on the device
+				device_changes_ = false;
+				return;
+			}
+
+			// our replica on the device of c would be overwritten by the next switch_device(), as we move there
+			typename replica_map::iterator replica = replicas_.find(c.device_id_);
+			if (replica != replicas_.end()) {
+				delete replica->second.memory;
+				delete replica->second.ref;
+				replicas_.erase(replica);
+			}
+
+			// the memory is allocated and the data copied on the device of c, which need not be the current one
+			impl::device_guard on_device (c.device_id_);
+
+			// our memory can be reused, if it is big enough and on the same device
+			if (memory_ptr_ == 0 || memory_ptr_ -> size() < c.device_size_ || device_id_ != c.device_id_) {
+				delete memory_ptr_;
+				memory_ptr_ = 0;
+
+				memory_ptr_ = new memory1d<T_device_type>(c.memory_ptr_ -> get_device(), c.device_size_);
+				ref_invalid_ = true;
+			} else {
+				// the work enqueued before may still use our memory
+				impl::wait_for_stream (c.stream_, stream_.get());
+
+				if (device_size_ != c.device_size_) {
+					ref_outdated_ = true;
+				}
+			}
+
+			// the copy is enqueued after the last kernel call of c, which may still write its data
+			stream_ = c.stream_;
+			memory_ptr_ -> use_in (stream_);
+			c.memory_ptr_ -> use_in (stream_);
+
+			// a kernel called in another stream waits for the copy like for a prefetch
+			device_prefetch_ = cupp::copy_device_to_device_async (memory_ptr_ -> cuda_pointer(), c.memory_ptr_ -> cuda_pointer(), c.device_size_, stream_.get());
+			device_prefetching_ = true;
+
+			// the pages already transfered to the host are up to date, so are we
+			data_           = c.data_;
+			resident_       = c.resident_;
+			missing_pages_  = c.missing_pages_;
+			device_changes_ = true;
+			host_changes_   = c.host_changes_;
+			device_size_    = c.device_size_;
+			device_id_      = c.device_id_;
+
+			for (typename replica_map::iterator it = replicas_.begin(); it != replicas_.end(); ++it) {
+				it->second.pending.mark_all();
+			}
+
+			spill_registry::instance().touch(this, device_id_);
+		}
+
+		/**
+		 * Waits for the transfer started by @c prefetch_to_host() and takes over the pages not on the host yet
+		 */
+		void finish_prefetch_to_host() const {
+			if (!host_prefetching_) {
+				return;
+			}
+
+			host_prefetch_.wait();
+			host_prefetching_ = false;
+
+			// our data may have been overwritten on the host in the meantime
+			if (device_changes_) {
+				const T_device_type* staged = static_cast<const T_device_type*>(prefetch_staging_);
+				const size_type per_page = elements_per_page();
+				for (size_type page = 0; page < resident_.size(); ++page) {
+					if (!resident_[page]) {
+						const size_type begin = page * per_page;
+						take_over (begin, std::min(begin + per_page, data_.size()), staged, bitwise_transfer());
+					}
+				}
+
+				std::fill (resident_.begin(), resident_.end(), true);
+				missing_pages_ = 0;
+				device_changes_ = false;
+			}
+
+			release_prefetch_staging();
+		}
+
+		/**
+		 * Our elements are their own device type, so the elements [@a begin, @a end) are copied straight from
+		 * @a staged into @a data_
+		 */
+		void take_over (const size_type begin, const size_type end, const T_device_type* staged, boost::true_type) const {
+			std::memcpy (&data_[begin], staged + begin, (end - begin) * sizeof(T));
+		}
+
+		/**
+		 * Our elements [@a begin, @a end) are converted from their device type in @a staged
+		 */
+		void take_over (const size_type begin, const size_type end, const T_device_type* staged, boost::false_type) const {
+			for (size_type i = begin; i < end; ++i) {
+				data_[i] = staged[i];
+			}
+		}
+
+		/**
+		 * Gives the staging buffer of @c prefetch_to_host() back to the @c staging_pool
+		 */
+		void release_prefetch_staging() const {
+			if (prefetch_staging_ != 0) {
+				staging_pool::instance().release (prefetch_staging_);
+				prefetch_staging_ = 0;
+			}
+		}
+
+		/**
+		 * Frees our memory on the device @a device_id, if our data can be transfered there again from the host
+		 * or from another device
+		 * @return The number of bytes freed
+		 */
+		std::size_t spill(const device::id_t device_id) {
+			if (device_id != device_id_) {
+				// a replica, the current device has all our data
+				typename replica_map::iterator it = replicas_.find(device_id);
+				if (it == replicas_.end() || it->second.memory == 0) {
+					return 0;
+				}
+
+				// a kernel enqueued in any stream may still read the replica
+				thread_synchronize();
+
+				const std::size_t bytes = it->second.memory -> size() * sizeof(T_device_type);
+				delete it->second.memory;
+				delete it->second.ref;
+				replicas_.erase(it);
+				return bytes;
+			}
+
+			// our data on the device is newer than on the host, it can't be rebuilt
+			if (memory_ptr_ == 0 || device_changes_) {
+				return 0;
+			}
+
+			const std::size_t bytes = memory_ptr_ -> size() * sizeof(T_device_type);
+
+			// a kernel or a transfer may still use our memory. @a stream_ is only the stream of our last transfer,
+			// a kernel using us unchanged may run in any other stream, so the whole device is waited for.
+			// Spilling only happens when the device ran out of memory (on the current device), so this is rare.
+			thread_synchronize();
+			uploads_.clear();
+			device_prefetching_ = false;
+
+			// the next kernel call allocates new memory and transfers all our data
+			delete memory_ptr_;
+			memory_ptr_ = 0;
+			delete device_ref_ptr_;
+			device_ref_ptr_ = 0;
+			ref_invalid_ = true;
+			device_size_ = 0;
+
+			return bytes;
+		}
+
+		/**
+		 * Tells the @c spill_registry about our memory on the current device and our replicas
+		 */
+		void register_device_memory() {
+			if (memory_ptr_ != 0) {
+				spill_registry::instance().touch(this, device_id_);
+			}
+
+			for (typename replica_map::iterator it = replicas_.begin(); it != replicas_.end(); ++it) {
+				if (it->second.memory != 0) {
+					spill_registry::instance().touch(this, it->first);
+				}
+			}
+		}
+
+		/**
+		 * Frees the replicas on all devices but the current one
+		 */
+		void drop_replicas() {
+			for (typename replica_map::iterator it = replicas_.begin(); it != replicas_.end(); ++it) {
+				delete it->second.memory;
+				delete it->second.ref;
+			}
+			replicas_.clear();
+		}
+
+		/**
+		 * Transfers the elements [@a begin, @a end) from the device, waits for @a stream_
+		 */
+		void download(const size_type begin, const size_type end) const {
+			download (begin, end, bitwise_transfer());
+		}
+
+		/**
+		 * Our elements are their own device type, so they are copied straight into @a data_
+		 */
+		void download(const size_type begin, const size_type end, boost::true_type) const {
+			copy_from_device (&data_[begin], begin, end - begin);
+		}
+
+		/**
+		 * Our elements are transfered as @a T_device_type and converted afterwards
+		 */
+		void download(const size_type begin, const size_type end, boost::false_type) const {
+			std::vector< T_device_type > temp( end - begin );
+
+			copy_from_device (&temp[0], begin, temp.size());
+
+			for (size_type i = 0; i < temp.size(); ++i) {
+				data_[begin + i] = temp[i];
+			}
+		}
+
+		/**
+		 * Copies @a count elements starting at @a offset from the device to @a destination, waits for @a stream_ only.
+		 * Big transfers are passed through the pooled chunks of the @c staging_pool piece by piece.
+		 */
+		void copy_from_device(T_device_type* destination, const size_type offset, const size_type count) const {
+			memory_ptr_ -> copy_to_host (count, destination, offset, stream_.get());
+		}
+
+		/**
+		 * Transfers the elements [@a begin, @a end) to the device, in @a stream_
+		 */
+		void upload(const device &d, const size_type begin, const size_type end) {
+			if (begin >= end) {
+				return;
+			}
+
+			upload (d, begin, end, bitwise_transfer());
+		}
+
+		/**
+		 * Our elements are their own device type, so they are copied straight from @a data_
+		 */
+		void upload(const device &d, const size_type begin, const size_type end, boost::true_type) {
+			UNUSED_PARAMETER(d);
+			copy_to_device (&data_[begin], begin, end - begin);
+		}
+
+		/**
+		 * Our elements are transformed to @a T_device_type first
+		 */
+		void upload(const device &d, const size_type begin, const size_type end, boost::false_type) {
+			std::vector< T_device_type > temp;
+			temp.reserve (end - begin);
+			for (size_type i = begin; i < end; ++i) {
+				temp.push_back ( kernel_call_traits< T, T_device_type >::transform (d, data_[i]) );
+			}
+
+			copy_to_device (&temp[0], begin, temp.size());
+		}
+
+		/**
+		 * Copies @a count elements from @a source to the device starting at @a offset, in @a stream_
+		 */
+		void copy_to_device(T_device_type const* source, const size_type offset, const size_type count) {
+			if (stream_.get() == 0) {
+				memory_ptr_ -> copy_to_device (count, source, offset);
+			} else {
+				// the data is staged, so source may be changed right away
+				uploads_.push_back ( memory_ptr_ -> copy_to_device_async (count, source, offset, stream_) );
 			}
 		}
-		
 
 	private:
+		/**
+		 * A jagged_vector stores its rows in one of us and marks them changed by a kernel
+		 */
+		template <typename> friend class jagged_vector;
+
+		/**
+		 * A tile of for_each_chunk() transfers its chunks straight to our memory on the device
+		 */
+		template <typename> friend class impl::chunk_tile;
+
+		/**
+		 * The copy of our data on a device we are not currently used on
+		 */
+		struct replica {
+			replica() : memory(0), size(0), ref(0), ref_invalid(true), ref_outdated(false), pending(true) {}
+
+			memory1d< T_device_type > *memory;
+			size_type size;
+			device_reference<device_type> *ref;
+			bool ref_invalid;
+			bool ref_outdated;
+
+			/**
+			 * The elements changed on the host or on another device, which are out of date in this replica
+			 */
+			impl::dirty_ranges pending;
+		};
+
+		typedef std::map<device::id_t, replica> replica_map;
+
 		/**
 		 * Our real vector :-)
 		 */
 		mutable std::vector<T> data_;
 		
 		/**
-		 * true means, data has been changed on the host and data on the device is out of date
+		 * The elements which have been changed on the host, their data on the device is out of date
 		 */
-		mutable bool host_changes_;
+		mutable impl::dirty_ranges host_changes_;
 
 		/**
 		 * true means, data has been changed on the device and data on the host is out of date
 		 */
 		mutable bool device_changes_;
 
+		/**
+		 * If @a device_changes_ is true: true for every page of our data already transfered back to the host
+		 */
+		mutable std::vector<bool> resident_;
+
+		/**
+		 * If @a device_changes_ is true: the number of pages not transfered back to the host
+		 */
+		mutable size_type missing_pages_;
+
 		/**
 		 * True means we have to recreate our proxy
 		 */
 		mutable bool ref_invalid_;
 
+		/**
+		 * True means the value of our proxy has to be updated, its address is still valid
+		 */
+		mutable bool ref_outdated_;
+
 		/**
 		 * Our device memory :-)
 		 */
 		mutable memory1d< T_device_type > *memory_ptr_;
 
+		/**
+		 * The number of our elements on the device, @c memory_ptr_->size() is the capacity
+		 */
+		mutable size_type device_size_;
+
 		/**
 		 * The proxy on our device
 		 */
@@ -683,11 +1505,46 @@ class vector {
 		 * A pointer to the device on which our data is stored
 		 */
 		mutable device::id_t device_id_;
+
+		/**
+		 * Our replicas on the other devices we have been used on
+		 */
+		mutable replica_map replicas_;
+
+		/**
+		 * The stream our data has been used in the last time on the device
+		 */
+		mutable stream stream_;
+
+		/**
+		 * The pending uploads of our data, keep the staging buffers alive
+		 */
+		std::vector<completion> uploads_;
+
+		/**
+		 * The transfer started by @c prefetch(), the next kernel call has to wait for it if @a device_prefetching_ is true
+		 */
+		completion device_prefetch_;
+		bool device_prefetching_;
+
+		/**
+		 * The transfer started by @c prefetch_to_host() into the staging buffer @a prefetch_staging_,
+		 * not taken over by us if @a host_prefetching_ is true
+		 */
+		mutable completion host_prefetch_;
+		mutable bool host_prefetching_;
+		mutable void* prefetch_staging_;
+
+		/**
+		 * true if we are a tile of for_each_chunk(), see @c resize_device_only()
+		 */
+		bool device_only_;
 }; // class vector
 
 
 template <typename T1, typename T2>
 bool operator==(const vector<T1>& c1, const vector<T2>& c2) {
+	impl::trace_trigger trigger ("comparison");
 	c1.update_host();
 	c2.update_host();
 	return c1.data_ == c2.data_;
@@ -700,6 +1557,7 @@ bool operator!=(const vector<T1>& c1, const vector<T2>& c2) {
 
 template <typename T1, typename T2>
 bool operator<(const vector<T1>& c1, const vector<T2>& c2) {
+	impl::trace_trigger trigger ("comparison");
 	c1.update_host();
 	c2.update_host();
 	return c1.data_ < c2.data_; 
@@ -707,6 +1565,7 @@ bool operator<(const vector<T1>& c1, const vector<T2>& c2) {
 
 template <typename T1, typename T2>
 bool operator>(const vector<T1>& c1, const vector<T2>& c2) {
+	impl::trace_trigger trigger ("comparison");
 	c1.update_host();
 	c2.update_host();
 	return c1.data_ > c2.data_;
@@ -722,6 +1581,14 @@ bool operator>=(const vector<T1>& c1, const vector<T2>& c2) {
 	return !(c1 < c2);
 }
 
+/**
+ * A vector passed by @c cupp::out() is not transfered to the device
+ */
+template <typename T>
+struct uses_access_mode< vector<T> > {
+	enum { value = true };
+};
+
 
 } // namespace cupp
 